@@ -130,6 +130,7 @@ void rcuReadUnlock(RCUZone& zone, int64_t epoch)
 
 void rcuSynchronize(RCUZone& zone)
 {
+	std::lock_guard<std::mutex> l{ zone.synchronizeMutex };
 	auto lastEpoch = zone.epochLatest.fetch_add(1, std::memory_order_release);
 	// wait for all the other readers to finish
 	auto nrBucketsOneZone = nrBucketsPerEpoch(zone);
@@ -143,6 +144,18 @@ void rcuSynchronize(RCUZone& zone)
 	}
 }
 
+int64_t rcuCurrentEpoch(RCUZone& zone)
+{
+	// a read-modify-write reads the latest epoch and heads a release sequence: the readers who
+	// get a later epoch from the next rcuSynchronize see the unlinking done before this call
+	return zone.epochLatest.fetch_add(0, std::memory_order_acq_rel);
+}
+
+bool rcuIfEpochDrained(RCUZone& zone, int64_t epoch)
+{
+	return zone.epochOldest.load(std::memory_order_acquire) > epoch;
+}
+
 RCUZone::~RCUZone()
 {
 	if (epochsRing[0].pBuckets)
@@ -1,5 +1,12 @@
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <thread>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "include/RCUApi.h"
 #include "include/RCUHashTableApi.h"
@@ -11,6 +18,9 @@ namespace yrcu
 {
 namespace
 {
+	// source of RTableCore::id
+	std::atomic<uint64_t> nextTableId = 1;
+
 	uint32_t upperBoundPowerOf2(uint32_t v)
 	{
 		if (v == 0)
@@ -25,16 +35,84 @@ namespace
 		return v;
 	}
 
-	RTableCore::BucketsInfo* allocateAndInitBuckets(size_t nrBucketsPowerOf2)
+#ifdef __linux__
+	constexpr size_t c_hugePageSize = size_t(2) << 20;
+
+	void interleaveOverAllowedNumaNodes(void* p, size_t size)
+	{
+		constexpr int c_mpolInterleave = 3;
+		constexpr int c_mpolFMemsAllowed = 4;
+		constexpr unsigned long c_maxNode = 1024;
+		unsigned long nodeMask[c_maxNode / (8 * sizeof(unsigned long))] = {};
+		long ret =
+				syscall(SYS_get_mempolicy, nullptr, nodeMask, c_maxNode, nullptr, c_mpolFMemsAllowed);
+		if (ret != 0)
+			return;
+		// best effort, the pages are just not interleaved if it fails
+		syscall(SYS_mbind, p, size, c_mpolInterleave, nodeMask, c_maxNode, 0);
+	}
+
+	// returns nullptr on failure, the pages are zero filled by the kernel on first touch
+	void* mapBuckets(const RTableCore& table, size_t& inOutSize)
+	{
+		void* p = MAP_FAILED;
+		if (table.bucketsUseHugeTlb)
+		{
+			size_t sizeHuge = (inOutSize + c_hugePageSize - 1) / c_hugePageSize * c_hugePageSize;
+			p = mmap(
+					nullptr,
+					sizeHuge,
+					PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+					-1,
+					0);
+			if (p != MAP_FAILED)
+				inOutSize = sizeHuge;
+		}
+		if (p == MAP_FAILED)
+		{
+			p = mmap(nullptr, inOutSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED)
+				return nullptr;
+			madvise(p, inOutSize, MADV_HUGEPAGE);
+		}
+		if (table.bucketsInterleaveNuma)
+			interleaveOverAllowedNumaNodes(p, inOutSize);
+		return p;
+	}
+#endif
+
+	RTableCore::BucketsInfo* allocateAndInitBuckets(
+			const RTableCore& table,
+			size_t nrBucketsPowerOf2)
 	{
 		assert(nrBucketsPowerOf2 > 0);
 		// allocate buckets info and the buckets together, better cache perf
 		size_t allocSize =
 				sizeof(RTableCore::BucketsInfo) + nrBucketsPowerOf2 * sizeof(RTableCore::Bucket);
+#ifdef __linux__
+		if (table.bucketsMmapThresholdBytes != 0 && allocSize >= table.bucketsMmapThresholdBytes)
+		{
+			if (void* p = mapBuckets(table, allocSize))
+			{
+				// no init loop: the all zero bits bucket is an empty list, and the pages are only
+				// touched (zero filled) when the resize or a writer fills the bucket
+				RTableCore::BucketsInfo* pBucketsInfo = (RTableCore::BucketsInfo*)p;
+				pBucketsInfo->nrBucketsPowerOf2 = nrBucketsPowerOf2;
+				pBucketsInfo->pBuckets =
+						(RTableCore::Bucket*)((char*)p + sizeof(RTableCore::BucketsInfo));
+				pBucketsInfo->allocSize = allocSize;
+				pBucketsInfo->mmapped = true;
+				return pBucketsInfo;
+			}
+		}
+#endif
 		void* p = malloc(allocSize);
 
 		RTableCore::BucketsInfo* pBucketsInfo = new (p) RTableCore::BucketsInfo();
 		pBucketsInfo->nrBucketsPowerOf2 = nrBucketsPowerOf2;
+		pBucketsInfo->allocSize = allocSize;
+		pBucketsInfo->mmapped = false;
 
 		char* pBucketsChar = (char*)p + sizeof(RTableCore::BucketsInfo);
 		RTableCore::Bucket* pBuckets = new (pBucketsChar) RTableCore::Bucket[nrBucketsPowerOf2];
@@ -51,6 +129,13 @@ namespace
 	{
 		static_assert(std::is_trivially_destructible_v<RTableCore::Bucket>);
 		static_assert(std::is_trivially_destructible_v<RTableCore::BucketsInfo>);
+#ifdef __linux__
+		if (p->mmapped)
+		{
+			munmap(p, p->allocSize);
+			return;
+		}
+#endif
 		free(p);
 	}
 
@@ -117,6 +202,8 @@ namespace
 		//
 		// After this function pZipStart->next points to Y (newJumpStart, end of
 		// seg1) and X->next points to the first x of seg2. Thus yyyY is "unzipped"
+		// (Nodes only change their order relative to nodes of the other bucket, so the
+		// adjacent equal nodes of rTableCoreInsertMulti stay adjacent.)
 		//
 		// After this function, the caller needs to call rcuSynchronize() to ensure
 		// that all the readers reading xxx(seg2) is doing so through a correct
@@ -220,8 +307,16 @@ namespace
 		return allFinished;
 	}
 
-	void unzip(RTableCore::BucketsInfo* bucketsInfoOld, size_t bucketMaskNew, RCUZone& rcuZone)
+	uint64_t nanosSince(std::chrono::steady_clock::time_point start)
+	{
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	}
+
+	// returns the number of grace periods waited
+	size_t unzip(RTableCore::BucketsInfo* bucketsInfoOld, size_t bucketMaskNew, RCUZone& rcuZone)
 	{
+		size_t nrGracePeriods = 0;
 		while (true)
 		{
 			bool allFinished = true;
@@ -237,7 +332,9 @@ namespace
 			if (allFinished)
 				break;
 			rcuSynchronize(rcuZone);
+			++nrGracePeriods;
 		}
+		return nrGracePeriods;
 	}
 
 	RTableCore::BucketsInfo* expandBucketsByFac2ReturnOld(RTableCore& table, RCUZone& zone)
@@ -246,7 +343,7 @@ namespace
 		size_t nrBucketsOld = bucketsInfoOld->nrBucketsPowerOf2;
 		size_t nrBucketsNew = nrBucketsOld * 2;
 		size_t bucketMaskNew = nrBucketsNew - 1;
-		RTableCore::BucketsInfo* bucketsInfo = allocateAndInitBuckets(nrBucketsNew);
+		RTableCore::BucketsInfo* bucketsInfo = allocateAndInitBuckets(table, nrBucketsNew);
 		for (size_t iHalf = 0; iHalf < nrBucketsOld; ++iHalf)
 		{
 			RTableCore::Bucket* pSrc = bucketsInfoOld->pBuckets + iHalf;
@@ -256,17 +353,22 @@ namespace
 			initTwinDstBuckets(pSrc, dst0, dst1, iHalf, iSecondHalf, bucketMaskNew);
 		}
 
+		// the new filter is sized for the new bucket count and freed with the same grace period
+		RTableBloom* pOldBloom = nullptr;
+		if (table.pBloom.load(std::memory_order_relaxed))
+			pOldBloom = rTableCoreDetail::rebuildBloom(table, bucketsInfoOld, nrBucketsNew);
 		// publish new buckets info
 		table.pBucketsInfo.store(bucketsInfo, std::memory_order_release);
 		// synchronize so that no one is reading the old buckets
 		// since we are going to use the old buckets for unzipping
 		rcuSynchronize(zone);
+		rTableCoreDetail::freeBloom(pOldBloom);
+		size_t nrGracePeriods = 1;
 
 		bool noNeedToUnzip = findFirstUnzipStarts(bucketsInfoOld, bucketMaskNew);
-		if (noNeedToUnzip)
-			return bucketsInfoOld;
-
-		unzip(bucketsInfoOld, bucketMaskNew, zone);
+		if (!noNeedToUnzip)
+			nrGracePeriods += unzip(bucketsInfoOld, bucketMaskNew, zone);
+		table.nrExpandGracePeriods.fetch_add(nrGracePeriods, std::memory_order_relaxed);
 		return bucketsInfoOld;
 	}
 
@@ -275,10 +377,10 @@ namespace
 		auto* bucketsInfoOld = table.pBucketsInfo.load(std::memory_order_relaxed);
 		size_t nrBucketsOld = bucketsInfoOld->nrBucketsPowerOf2;
 		size_t nrBucketsNew = nrBucketsOld / 2;
-		if (nrBucketsNew == 0)
+		if (nrBucketsNew == 0 || nrBucketsNew < table.nrWriterStripesPowerOf2)
 			return nullptr;
 		size_t bucketMask = nrBucketsNew - 1;
-		RTableCore::BucketsInfo* bucketsInfoNew = allocateAndInitBuckets(nrBucketsNew);
+		RTableCore::BucketsInfo* bucketsInfoNew = allocateAndInitBuckets(table, nrBucketsNew);
 		for (size_t iHalf = 0; iHalf < nrBucketsNew; ++iHalf)
 		{
 			RTableCore::Bucket* pDst = bucketsInfoNew->pBuckets + iHalf;
@@ -287,19 +389,57 @@ namespace
 			RTableCore::Bucket* pSrc1 = bucketsInfoOld->pBuckets + iSecondHalf;
 			shrinkTwoBucketsToOne(&pSrc0->list, &pSrc1->list, &pDst->list);
 		}
+		RTableBloom* pOldBloom = nullptr;
+		if (table.pBloom.load(std::memory_order_relaxed))
+			pOldBloom = rTableCoreDetail::rebuildBloom(table, bucketsInfoNew, nrBucketsNew);
 		table.pBucketsInfo.store(bucketsInfoNew, std::memory_order_release);
 		rcuSynchronize(rcuZone);
+		rTableCoreDetail::freeBloom(pOldBloom);
 		return bucketsInfoOld;
 	}
+
+	// returns false if another writer is resizing, otherwise all the stripes are locked
+	bool tryLockForResize(RTableCore& table)
+	{
+		if (table.writerResizing.exchange(true, std::memory_order_acquire))
+			return false;
+		// other writers hold at most one stripe, so taking all of them cannot deadlock
+		for (size_t iStripe = 0; iStripe < table.nrWriterStripesPowerOf2; ++iStripe)
+			rTableCoreDetail::lockWriterStripe(table, iStripe);
+		return true;
+	}
+
+	void unlockForResize(RTableCore& table)
+	{
+		for (size_t iStripe = 0; iStripe < table.nrWriterStripesPowerOf2; ++iStripe)
+			rTableCoreDetail::unlockWriterStripe(table, iStripe);
+		table.writerResizing.store(false, std::memory_order_release);
+	}
 }	 // namespace
 
 void rTableCoreInitDetailed(RTableCore& table, const RTableCoreConfig& conf)
 {
 	auto nrBucketsPowerOf2 = upperBoundPowerOf2(conf.nrBuckets);
-	RTableCore::BucketsInfo* bucketsInfo = allocateAndInitBuckets(nrBucketsPowerOf2);
+	if (conf.nrWriterStripes > 0)
+	{
+		table.nrWriterStripesPowerOf2 = upperBoundPowerOf2(conf.nrWriterStripes);
+		table.pWriterStripes = new RTableWriterStripe[table.nrWriterStripesPowerOf2];
+		if (nrBucketsPowerOf2 < table.nrWriterStripesPowerOf2)
+			nrBucketsPowerOf2 = static_cast<uint32_t>(table.nrWriterStripesPowerOf2);
+	}
 	table.expandFactor = conf.expandFactor;
 	table.shrinkFactor = conf.shrinkFactor;
+	table.bucketsMmapThresholdBytes = conf.bucketsMmapThresholdBytes;
+	table.bucketsUseHugeTlb = conf.bucketsUseHugeTlb;
+	table.bucketsInterleaveNuma = conf.bucketsInterleaveNuma;
+	table.mixHash = conf.mixHash;
+	table.bloomBitsPerElement = conf.bloomBitsPerElement;
+	table.handleNodes = conf.handleNodes;
+	table.id = nextTableId.fetch_add(1, std::memory_order_relaxed);
+	RTableCore::BucketsInfo* bucketsInfo = allocateAndInitBuckets(table, nrBucketsPowerOf2);
 	table.pBucketsInfo.store(bucketsInfo, std::memory_order_relaxed);
+	if (table.bloomBitsPerElement > 0)
+		rTableCoreDetail::rebuildBloom(table, bucketsInfo, nrBucketsPowerOf2);
 }
 
 void rTableInitDetailed(RTable& table, const RTableConfig& conf)
@@ -309,6 +449,13 @@ void rTableInitDetailed(RTable& table, const RTableConfig& conf)
 	confCore.expandFactor = conf.expandFactor;
 	confCore.nrBuckets = conf.nrBuckets;
 	confCore.shrinkFactor = conf.shrinkFactor;
+	confCore.nrWriterStripes = conf.nrWriterStripes;
+	confCore.bucketsMmapThresholdBytes = conf.bucketsMmapThresholdBytes;
+	confCore.bucketsUseHugeTlb = conf.bucketsUseHugeTlb;
+	confCore.bucketsInterleaveNuma = conf.bucketsInterleaveNuma;
+	confCore.mixHash = conf.mixHash;
+	confCore.bloomBitsPerElement = conf.bloomBitsPerElement;
+	confCore.handleNodes = conf.handleNodes;
 	rTableCoreInitDetailed(table.core, confCore);
 }
 
@@ -324,10 +471,10 @@ void rTableInit(RTable& table, int nrBuckets)
 // can only be called if the user is sure that no dup exists
 void rTableCoreInsertNoExpand(RTableCore& table, RNode* pEntry)
 {
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreHandleTryInsert");
+	rTableCoreDetail::bloomAdd(table, pEntry->hash);
 	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
-	auto bucketMask = pBucketsInfo->nrBucketsPowerOf2 - 1;
-	size_t bucketId = pEntry->hash & bucketMask;
-	RTableCore::Bucket* pBucket = pBucketsInfo->pBuckets + bucketId;
+	RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, pEntry->hash);
 	pEntry->head.next.store(pBucket->list.head.next, std::memory_order_release);
 	pBucket->list.head.next.store(&pEntry->head, std::memory_order_release);
 	table.size.fetch_add(1, std::memory_order_relaxed);
@@ -348,10 +495,20 @@ void rTableSynchronize(RTable& table)
 	rcuSynchronize(table.rcuZone);
 }
 
+void rTableInsertNoExpand(RTable& table, RNode* pEntry)
+{
+	rTableCoreInsertNoExpand(table.core, pEntry);
+}
+
 void rTableCoreExpandBuckets2x(RTableCore& table, RCUZone& zone)
 {
+	auto start = std::chrono::steady_clock::now();
 	auto pOldInfo = expandBucketsByFac2ReturnOld(table, zone);
 	destroyAndFreeBuckets(pOldInfo);
+	if (table.handleNodes)
+		rTableCoreDetail::relinkBackPointers(table);
+	table.nrExpands.fetch_add(1, std::memory_order_relaxed);
+	table.expandNanos.fetch_add(nanosSince(start), std::memory_order_relaxed);
 }
 
 void rTableExpandBuckets2x(RTable& table)
@@ -361,10 +518,15 @@ void rTableExpandBuckets2x(RTable& table)
 
 bool rTableCoreShrinkBuckets2x(RTableCore& table, RCUZone& zone)
 {
+	auto start = std::chrono::steady_clock::now();
 	auto pOldInfo = shrinkBucketsByFac2ReturnOld(table, zone);
 	if (!pOldInfo)
 		return false;
 	destroyAndFreeBuckets(pOldInfo);
+	if (table.handleNodes)
+		rTableCoreDetail::relinkBackPointers(table);
+	table.nrShrinks.fetch_add(1, std::memory_order_relaxed);
+	table.shrinkNanos.fetch_add(nanosSince(start), std::memory_order_relaxed);
 	return true;
 }
 
@@ -373,15 +535,184 @@ bool rTableShrinkBuckets2x(RTable& table)
 	return rTableCoreShrinkBuckets2x(table.core, table.rcuZone);
 }
 
+void rTableCoreDetachNode(RTableCore& table, RHandleNode* pNode)
+{
+	RcuSlistHead* pNext = pNode->node.head.next.load(std::memory_order_relaxed);
+	pNode->pPrev->next.store(pNext, std::memory_order_release);
+	if (pNext)
+		rTableCoreDetail::handleOf(pNext)->pPrev = pNode->pPrev;
+	table.size.fetch_sub(1, std::memory_order_relaxed);
+	rTableCoreDetail::bloomNoteRemoved(table, 1);
+	rTableCoreDetail::bumpGeneration(table);
+}
+
+void rTableCoreDetachNodeAndSynchronize(RTableCore& table, RCUZone& rcuZone, RHandleNode* pNode)
+{
+	rTableCoreDetachNode(table, pNode);
+	if (!rTableCoreDetail::shrinkBucketsToFit(table, rcuZone))
+		rcuSynchronize(rcuZone);
+}
+
+void rTableDetachNode(RTable& table, RHandleNode* pNode)
+{
+	rTableCoreDetachNode(table.core, pNode);
+}
+
+void rTableDetachNodeAndSynchronize(RTable& table, RHandleNode* pNode)
+{
+	rTableCoreDetachNodeAndSynchronize(table.core, table.rcuZone, pNode);
+}
+
+RTableStats rTableCoreGetStats(const RTableCore& table, size_t nrSampledBuckets)
+{
+	RTableStats stats;
+	const RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	stats.nrBuckets = pInfo->nrBucketsPowerOf2;
+	stats.size = table.size.load(std::memory_order_relaxed);
+	stats.loadFactor = float(stats.size) / float(stats.nrBuckets);
+	size_t stride = 1;
+	if (nrSampledBuckets != 0 && nrSampledBuckets < stats.nrBuckets)
+		stride = stats.nrBuckets / nrSampledBuckets;
+	size_t nrNodes = 0;
+	for (size_t iBucket = 0; iBucket < stats.nrBuckets; iBucket += stride)
+	{
+		size_t chainLength = 0;
+		auto count = [&chainLength](RNode*) { ++chainLength; };
+		rTableCoreDetail::forEachInBuckets(pInfo, iBucket, iBucket + 1, count);
+		size_t iBin = std::min(chainLength, c_rTableStatsNrHistogramBins - 1);
+		++stats.chainLengthHistogram[iBin];
+		stats.maxChainLength = std::max(stats.maxChainLength, chainLength);
+		nrNodes += chainLength;
+		++stats.nrVisitedBuckets;
+	}
+	stats.avgChainLength = float(nrNodes) / float(stats.nrVisitedBuckets);
+
+	stats.nrExpands = table.nrExpands.load(std::memory_order_relaxed);
+	stats.expandNanos = table.expandNanos.load(std::memory_order_relaxed);
+	stats.nrExpandGracePeriods = table.nrExpandGracePeriods.load(std::memory_order_relaxed);
+	stats.nrShrinks = table.nrShrinks.load(std::memory_order_relaxed);
+	stats.shrinkNanos = table.shrinkNanos.load(std::memory_order_relaxed);
+	return stats;
+}
+
+RTableStats rTableGetStats(RTable& table, size_t nrSampledBuckets)
+{
+	RTableReadLockGuard l(table);
+	return rTableCoreGetStats(table.core, nrSampledBuckets);
+}
+
 RTableCore::~RTableCore()
 {
 	auto* p = pBucketsInfo.load();
 	if (p)
 		destroyAndFreeBuckets(p);
+	rTableCoreDetail::freeBloom(pBloom.load());
+	delete[] pWriterStripes;
 }
 
 namespace rTableCoreDetail
 {
+	void relinkBackPointers(RTableCore& table)
+	{
+		RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+		for (size_t iBucket = 0; iBucket < pInfo->nrBucketsPowerOf2; ++iBucket)
+		{
+			RcuSlistHead* pPrev = &pInfo->pBuckets[iBucket].list.head;
+			for (RcuSlistHead* p = pPrev->next.load(std::memory_order_relaxed); p != nullptr;
+					 p = p->next.load(std::memory_order_relaxed))
+			{
+				handleOf(p)->pPrev = pPrev;
+				pPrev = p;
+			}
+		}
+	}
+
+	RTableCore::BucketsInfo*
+	bulkReserveBuckets(RTableCore& table, RCUZone& zone, size_t nrElements, bool& outUnpublished)
+	{
+		size_t nrBucketsNeeded = 1;
+		while ((float)nrElements > table.expandFactor * float(nrBucketsNeeded))
+			nrBucketsNeeded *= 2;
+		RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+		outUnpublished = false;
+		if (nrBucketsNeeded <= pInfo->nrBucketsPowerOf2)
+			return pInfo;
+		// nothing to move, fill a new array directly instead of expanding step by step
+		if (table.size.load(std::memory_order_relaxed) == 0)
+		{
+			outUnpublished = true;
+			return allocateAndInitBuckets(table, nrBucketsNeeded);
+		}
+		while (table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2 < nrBucketsNeeded)
+			rTableCoreExpandBuckets2x(table, zone);
+		return table.pBucketsInfo.load(std::memory_order_relaxed);
+	}
+
+	void bulkPublishBuckets(RTableCore& table, RCUZone& zone, RTableCore::BucketsInfo* pBucketsInfo)
+	{
+		RTableCore::BucketsInfo* pOldInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+		RTableBloom* pOldBloom = nullptr;
+		if (table.pBloom.load(std::memory_order_relaxed))
+			pOldBloom = rebuildBloom(table, pBucketsInfo, pBucketsInfo->nrBucketsPowerOf2);
+		table.pBucketsInfo.store(pBucketsInfo, std::memory_order_release);
+		rcuSynchronize(zone);
+		destroyAndFreeBuckets(pOldInfo);
+		freeBloom(pOldBloom);
+	}
+
+	RTableBloom* rebuildBloom(
+			RTableCore& table,
+			const RTableCore::BucketsInfo* pNodesInfo,
+			size_t nrBuckets)
+	{
+		RTableBloom* pBloom = new RTableBloom;
+		// the elements before the next expand
+		pBloom->capacity = std::max(size_t(64), size_t(table.expandFactor * float(nrBuckets)));
+		size_t nrBlocks = (pBloom->capacity * (size_t)table.bloomBitsPerElement + 511) / 512;
+		pBloom->nrBlocksPowerOf2 = 1;
+		while (pBloom->nrBlocksPowerOf2 < nrBlocks)
+			pBloom->nrBlocksPowerOf2 *= 2;
+		pBloom->pBlocks = new RTableBloomBlock[pBloom->nrBlocksPowerOf2];
+		auto add = [pBloom](RNode* pNode)
+		{
+			size_t iBlock;
+			uint64_t masks[8];
+			bloomMasks(pBloom, pNode->hash, iBlock, masks);
+			for (int iWord = 0; iWord < 8; ++iWord)
+				pBloom->pBlocks[iBlock].words[iWord].fetch_or(masks[iWord], std::memory_order_relaxed);
+		};
+		forEachInBuckets(pNodesInfo, 0, pNodesInfo->nrBucketsPowerOf2, add);
+		RTableBloom* pOld = table.pBloom.load(std::memory_order_relaxed);
+		table.pBloom.store(pBloom, std::memory_order_release);
+		return pOld;
+	}
+
+	void freeBloom(RTableBloom* pBloom)
+	{
+		if (!pBloom)
+			return;
+		delete[] pBloom->pBlocks;
+		delete pBloom;
+	}
+
+	// returns if synchronized
+	bool rebuildBloomIfStale(RTableCore& table, RCUZone& zone)
+	{
+		RTableBloom* pBloom = table.pBloom.load(std::memory_order_relaxed);
+		if (!pBloom)
+			return false;
+		// the stale bits count like live nodes for the false positive rate
+		size_t nrRemoved = pBloom->nrRemoved.load(std::memory_order_relaxed);
+		if (nrRemoved == 0 ||
+				table.size.load(std::memory_order_relaxed) + nrRemoved <= pBloom->capacity)
+			return false;
+		RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+		RTableBloom* pOldBloom = rebuildBloom(table, pInfo, pInfo->nrBucketsPowerOf2);
+		rcuSynchronize(zone);
+		freeBloom(pOldBloom);
+		return true;
+	}
+
 	void expandBucketsByFac2IfNecessary(
 			size_t nrElements,
 			size_t nrBuckets,
@@ -398,9 +729,73 @@ namespace rTableCoreDetail
 			RTableCore& table,
 			RCUZone& zone)
 	{
-		if ((float)nrElements < table.shrinkFactor * float(nrBuckets) && nrElements > 128)
-			return rTableCoreShrinkBuckets2x(table, zone);
-		return false;
+		if ((float)nrElements < table.shrinkFactor * float(nrBuckets) && nrElements > 128 &&
+				rTableCoreShrinkBuckets2x(table, zone))
+			return true;
+		return rebuildBloomIfStale(table, zone);
+	}
+
+	bool shrinkBucketsToFit(RTableCore& table, RCUZone& zone)
+	{
+		bool ifSynchronized = false;
+		while (shrinkBucketsByFac2IfNecessary(
+				table.size.load(std::memory_order_relaxed),
+				table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2,
+				table,
+				zone))
+			ifSynchronized = true;
+		return ifSynchronized;
+	}
+
+	void lockWriterStripe(RTableCore& table, size_t hashVal)
+	{
+		RTableWriterStripe& stripe =
+				table.pWriterStripes[hashVal & (table.nrWriterStripesPowerOf2 - 1)];
+		while (stripe.locked.exchange(true, std::memory_order_acquire))
+			// spin on a load to keep the cache line shared while waiting,
+			// yield since the holder might be resizing with several grace periods
+			while (stripe.locked.load(std::memory_order_relaxed))
+				std::this_thread::yield();
+	}
+
+	void unlockWriterStripe(RTableCore& table, size_t hashVal)
+	{
+		table.pWriterStripes[hashVal & (table.nrWriterStripesPowerOf2 - 1)].locked.store(
+				false, std::memory_order_release);
+	}
+
+	void concurrentExpandIfNecessary(
+			size_t nrElements,
+			size_t nrBuckets,
+			RTableCore& table,
+			RCUZone& zone)
+	{
+		if ((float)nrElements <= table.expandFactor * float(nrBuckets))
+			return;
+		if (!tryLockForResize(table))
+			return;
+		// check again, the table might have been resized after the caller looked
+		nrElements = table.size.load(std::memory_order_relaxed);
+		nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+		expandBucketsByFac2IfNecessary(nrElements, nrBuckets, table, zone);
+		unlockForResize(table);
+	}
+
+	bool concurrentShrinkIfNecessary(
+			size_t nrElements,
+			size_t nrBuckets,
+			RTableCore& table,
+			RCUZone& zone)
+	{
+		if ((float)nrElements >= table.shrinkFactor * float(nrBuckets) || nrElements <= 128)
+			return false;
+		if (!tryLockForResize(table))
+			return false;
+		nrElements = table.size.load(std::memory_order_relaxed);
+		nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+		bool ifSynchronized = shrinkBucketsByFac2IfNecessary(nrElements, nrBuckets, table, zone);
+		unlockForResize(table);
+		return ifSynchronized;
 	}
 }	 // namespace rTableCoreDetail
 }	 // namespace yrcu
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RCUHashTableCoreApi.h"
+#include "include/RCacheApi.h"
+#include "include/RCacheTypes.h"
+#include "include/RcuDoublyLinkedListApi.h"
+
+namespace yrcu
+{
+namespace
+{
+	// the ring head is not an entry, skip it. Returns &ring.head only if the ring is empty.
+	RcuDlistHead* nextInRing(RCache& cache, RcuDlistHead* p)
+	{
+		RcuDlistHead* pNext = p->next.load(std::memory_order_relaxed);
+		if (pNext == &cache.ring.head)
+			pNext = pNext->next.load(std::memory_order_relaxed);
+		return pNext;
+	}
+}	 // namespace
+
+void rCacheInitDetailed(RCache& cache, const RCacheConfig& conf)
+{
+	rcuInitZoneWithBucketCounts(cache.rcuZone, conf.nrRcuBucketsForUnregisteredThreads);
+	RTableCoreConfig confCore;
+	// sized for a full cache, so that it never expands in the steady state
+	confCore.nrBuckets = (int)std::min<size_t>(std::max<size_t>(conf.capacity, 1), size_t(1) << 30);
+	rTableCoreInitDetailed(cache.core, confCore);
+	rcuDlistInit(&cache.ring);
+	cache.pHand = &cache.ring.head;
+	cache.capacity = conf.capacity;
+	cache.nrEvictBatch =
+			std::clamp<size_t>(conf.nrEvictBatch, 1, std::max<size_t>(conf.capacity, 1));
+}
+
+void rCacheInit(RCache& cache, size_t capacity)
+{
+	RCacheConfig conf;
+	conf.capacity = capacity;
+	conf.nrRcuBucketsForUnregisteredThreads = std::thread::hardware_concurrency() * 64;
+	rCacheInitDetailed(cache, conf);
+}
+
+int64_t rCacheReadLock(RCache& cache)
+{
+	return rcuReadLock(cache.rcuZone);
+}
+
+void rCacheReadUnlock(RCache& cache, int64_t epoch)
+{
+	rcuReadUnlock(cache.rcuZone, epoch);
+}
+
+size_t rCacheSize(const RCache& cache)
+{
+	return cache.core.size.load(std::memory_order_relaxed);
+}
+
+namespace rCacheDetail
+{
+	void ringLink(RCache& cache, RCacheNode* pNode)
+	{
+		rcuDlistInsertBefore(cache.pHand, &pNode->ringHead);
+		if (cache.pHand == &cache.ring.head)
+			cache.pHand = &pNode->ringHead;
+	}
+
+	void ringUnlink(RCache& cache, RCacheNode* pNode)
+	{
+		if (cache.pHand == &pNode->ringHead)
+			cache.pHand = nextInRing(cache, cache.pHand);
+		rcuDlistRemove(&pNode->ringHead);
+		// it was the only entry
+		if (cache.pHand == &pNode->ringHead)
+			cache.pHand = &cache.ring.head;
+	}
+
+	void detachCold(
+			RCache& cache,
+			size_t nrEntries,
+			std::vector<RCacheNode*>& outDetached,
+			const RCacheNode* pKeep)
+	{
+		size_t size = cache.core.size.load(std::memory_order_relaxed);
+		// pKeep stays, so the sweep cannot run out of entries to detach
+		if (pKeep)
+			nrEntries = std::min(nrEntries, size - 1);
+		// at most one round of second chances, so that readers hitting every entry cannot keep
+		// the sweep going forever
+		size_t nrSecondChancesLeft = size;
+		while (outDetached.size() < nrEntries && cache.pHand != &cache.ring.head)
+		{
+			RCacheNode* pNode = YJ_CONTAINER_OF(cache.pHand, RCacheNode, ringHead);
+			if (pNode == pKeep)
+			{
+				cache.pHand = nextInRing(cache, cache.pHand);
+				continue;
+			}
+			if (nrSecondChancesLeft > 0 && pNode->referenced.load(std::memory_order_relaxed))
+			{
+				--nrSecondChancesLeft;
+				pNode->referenced.store(false, std::memory_order_relaxed);
+				cache.pHand = nextInRing(cache, cache.pHand);
+				continue;
+			}
+			// the stored hash, which must not be mixed again
+			rTableCoreDetail::tryDetachByBucketHash(
+					cache.core, pNode->entry.hash, [pNode](const RNode* p) { return p == &pNode->entry; });
+			ringUnlink(cache, pNode);
+			outDetached.push_back(pNode);
+		}
+	}
+}	 // namespace rCacheDetail
+}	 // namespace yrcu
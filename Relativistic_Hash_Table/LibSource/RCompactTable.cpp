@@ -0,0 +1,225 @@
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RCompactTableApi.h"
+#include "include/RCompactTableTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	using rCompactTableDetail::nodeAt;
+
+	RCompactTable::BucketsInfo* allocateBuckets(size_t nrBucketsPowerOf2)
+	{
+		RCompactTable::BucketsInfo* pInfo = new RCompactTable::BucketsInfo;
+		pInfo->nrBucketsPowerOf2 = nrBucketsPowerOf2;
+		pInfo->pBuckets = new std::atomic<uint32_t>[nrBucketsPowerOf2];
+		for (size_t iBucket = 0; iBucket < nrBucketsPowerOf2; ++iBucket)
+			pInfo->pBuckets[iBucket].store(c_rCompactNull, std::memory_order_relaxed);
+		return pInfo;
+	}
+
+	void freeBuckets(RCompactTable::BucketsInfo* pInfo)
+	{
+		delete[] pInfo->pBuckets;
+		delete pInfo;
+	}
+
+	size_t bucketIdOf(const RCompactTable& table, uint32_t index, size_t bucketMask)
+	{
+		return nodeAt(table, index)->hash & bucketMask;
+	}
+
+	// same as the unzipOneSegment of RTableCore, on arena indices.
+	// *pZipStart is the last node of a segment whose successor belongs to the twin bucket
+	void unzipOneSegment(RCompactTable& table, std::atomic<uint32_t>* pZipStart, size_t bucketMask)
+	{
+		uint32_t jumpStart = pZipStart->load(std::memory_order_relaxed);
+		size_t jumpStartBucketId = bucketIdOf(table, jumpStart, bucketMask);
+		RCompactNode* pJumpStart = nodeAt(table, jumpStart);
+		uint32_t nextJumpStart = pJumpStart->next.load(std::memory_order_relaxed);
+		uint32_t next;
+		while (true)
+		{
+			next = nodeAt(table, nextJumpStart)->next.load(std::memory_order_relaxed);
+			if (next == c_rCompactNull)
+			{
+				nextJumpStart = c_rCompactNull;
+				break;
+			}
+			if (bucketIdOf(table, next, bucketMask) == jumpStartBucketId)
+				break;
+			nextJumpStart = next;
+		}
+		pZipStart->store(nextJumpStart, std::memory_order_relaxed);
+		pJumpStart->next.store(next, std::memory_order_release);
+	}
+
+	// the old buckets are reused as the zip cursors, set to the last node of the first segment
+	// or c_rCompactNull if the chain is not zipped
+	bool findFirstUnzipPoint(RCompactTable& table, std::atomic<uint32_t>* pSrc, size_t bucketMask)
+	{
+		uint32_t index = pSrc->load(std::memory_order_relaxed);
+		size_t initialBucketId = bucketIdOf(table, index, bucketMask);
+		while (true)
+		{
+			uint32_t next = nodeAt(table, index)->next.load(std::memory_order_relaxed);
+			if (next == c_rCompactNull)
+			{
+				index = c_rCompactNull;
+				break;
+			}
+			if (bucketIdOf(table, next, bucketMask) != initialBucketId)
+				break;
+			index = next;
+		}
+		pSrc->store(index, std::memory_order_relaxed);
+		return index != c_rCompactNull;
+	}
+}	 // namespace
+
+RCompactTable::~RCompactTable()
+{
+	auto* p = pBucketsInfo.load();
+	if (p)
+		freeBuckets(p);
+}
+
+void rCompactTableInitDetailed(
+		RCompactTable& table,
+		void* pArenaBase,
+		size_t nodeStride,
+		size_t nodeOffset,
+		const RCompactTableConfig& conf)
+{
+	rcuInitZoneWithBucketCounts(table.rcuZone, conf.nrRcuBucketsForUnregisteredThreads);
+	table.pArenaBase = (char*)pArenaBase;
+	table.nodeStride = nodeStride;
+	table.nodeOffset = nodeOffset;
+	table.expandFactor = conf.expandFactor;
+	table.shrinkFactor = conf.shrinkFactor;
+	size_t nrBuckets = 1;
+	while (nrBuckets < (size_t)conf.nrBuckets)
+		nrBuckets *= 2;
+	table.pBucketsInfo.store(allocateBuckets(nrBuckets), std::memory_order_relaxed);
+}
+
+void rCompactTableInit(
+		RCompactTable& table,
+		void* pArenaBase,
+		size_t nodeStride,
+		size_t nodeOffset,
+		int nrBuckets)
+{
+	RCompactTableConfig conf;
+	conf.nrBuckets = nrBuckets;
+	conf.nrRcuBucketsForUnregisteredThreads = std::thread::hardware_concurrency() * 64;
+	rCompactTableInitDetailed(table, pArenaBase, nodeStride, nodeOffset, conf);
+}
+
+int64_t rCompactTableReadLock(RCompactTable& table)
+{
+	return rcuReadLock(table.rcuZone);
+}
+
+void rCompactTableReadUnlock(RCompactTable& table, int64_t epoch)
+{
+	rcuReadUnlock(table.rcuZone, epoch);
+}
+
+size_t rCompactTableSize(const RCompactTable& table)
+{
+	return table.size.load(std::memory_order_relaxed);
+}
+
+void rCompactTableExpandBuckets2x(RCompactTable& table)
+{
+	RCompactTable::BucketsInfo* pOld = table.pBucketsInfo.load(std::memory_order_relaxed);
+	size_t nrBucketsOld = pOld->nrBucketsPowerOf2;
+	size_t bucketMaskNew = nrBucketsOld * 2 - 1;
+	RCompactTable::BucketsInfo* pNew = allocateBuckets(nrBucketsOld * 2);
+	// each new bucket points to the first node of its own in the zipped old chain
+	for (size_t iHalf = 0; iHalf < nrBucketsOld; ++iHalf)
+		for (uint32_t index = pOld->pBuckets[iHalf].load(std::memory_order_relaxed);
+				 index != c_rCompactNull;
+				 index = nodeAt(table, index)->next.load(std::memory_order_relaxed))
+		{
+			std::atomic<uint32_t>* pDst = pNew->pBuckets + bucketIdOf(table, index, bucketMaskNew);
+			if (pDst->load(std::memory_order_relaxed) == c_rCompactNull)
+				pDst->store(index, std::memory_order_relaxed);
+		}
+	table.pBucketsInfo.store(pNew, std::memory_order_release);
+	// no reader is on the old buckets anymore, they become the zip cursors
+	rcuSynchronize(table.rcuZone);
+
+	bool allFinished = true;
+	for (size_t iHalf = 0; iHalf < nrBucketsOld; ++iHalf)
+		if (pOld->pBuckets[iHalf].load(std::memory_order_relaxed) != c_rCompactNull &&
+				findFirstUnzipPoint(table, pOld->pBuckets + iHalf, bucketMaskNew))
+			allFinished = false;
+	while (!allFinished)
+	{
+		allFinished = true;
+		for (size_t iHalf = 0; iHalf < nrBucketsOld; ++iHalf)
+			if (pOld->pBuckets[iHalf].load(std::memory_order_relaxed) != c_rCompactNull)
+			{
+				allFinished = false;
+				unzipOneSegment(table, pOld->pBuckets + iHalf, bucketMaskNew);
+			}
+		if (!allFinished)
+			rcuSynchronize(table.rcuZone);
+	}
+	freeBuckets(pOld);
+}
+
+bool rCompactTableShrinkBuckets2x(RCompactTable& table)
+{
+	RCompactTable::BucketsInfo* pOld = table.pBucketsInfo.load(std::memory_order_relaxed);
+	size_t nrBucketsNew = pOld->nrBucketsPowerOf2 / 2;
+	if (nrBucketsNew == 0)
+		return false;
+	RCompactTable::BucketsInfo* pNew = allocateBuckets(nrBucketsNew);
+	for (size_t iHalf = 0; iHalf < nrBucketsNew; ++iHalf)
+	{
+		// splice the chain of the second half behind the one of the first half
+		uint32_t first0 = pOld->pBuckets[iHalf].load(std::memory_order_relaxed);
+		uint32_t first1 = pOld->pBuckets[iHalf + nrBucketsNew].load(std::memory_order_relaxed);
+		if (first0 == c_rCompactNull)
+		{
+			pNew->pBuckets[iHalf].store(first1, std::memory_order_relaxed);
+			continue;
+		}
+		uint32_t last0 = first0;
+		for (uint32_t next = nodeAt(table, last0)->next.load(std::memory_order_relaxed);
+				 next != c_rCompactNull;
+				 next = nodeAt(table, last0)->next.load(std::memory_order_relaxed))
+			last0 = next;
+		nodeAt(table, last0)->next.store(first1, std::memory_order_release);
+		pNew->pBuckets[iHalf].store(first0, std::memory_order_relaxed);
+	}
+	table.pBucketsInfo.store(pNew, std::memory_order_release);
+	rcuSynchronize(table.rcuZone);
+	freeBuckets(pOld);
+	return true;
+}
+
+namespace rCompactTableDetail
+{
+	void expandIfNecessary(RCompactTable& table)
+	{
+		size_t nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+		if ((float)table.size.load(std::memory_order_relaxed) > table.expandFactor * float(nrBuckets))
+			rCompactTableExpandBuckets2x(table);
+	}
+
+	bool shrinkIfNecessary(RCompactTable& table)
+	{
+		size_t nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+		size_t nrElements = table.size.load(std::memory_order_relaxed);
+		if ((float)nrElements < table.shrinkFactor * float(nrBuckets) && nrElements > 128)
+			return rCompactTableShrinkBuckets2x(table);
+		return false;
+	}
+}	 // namespace rCompactTableDetail
+}	 // namespace yrcu
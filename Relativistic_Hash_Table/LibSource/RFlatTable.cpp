@@ -0,0 +1,295 @@
+#include <cassert>
+#include <cstdlib>
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RFlatTableApi.h"
+#include "include/RFlatTableTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	size_t upperBoundPowerOf2(size_t v)
+	{
+		if (v == 0)
+			return 1;
+		v--;
+		v |= v >> 1;
+		v |= v >> 2;
+		v |= v >> 4;
+		v |= v >> 8;
+		v |= v >> 16;
+		v |= v >> 32;
+		v++;
+		return v;
+	}
+
+	size_t nrSlotsOf(const RFlatTableCore::SlotsInfo* pInfo)
+	{
+		return pInfo->nrGroupsPowerOf2 * c_rFlatGroupSize;
+	}
+
+	RFlatTableCore::SlotsInfo* allocateAndInitSlots(size_t nrGroupsPowerOf2)
+	{
+		assert(nrGroupsPowerOf2 > 0);
+		// allocate slots info, control words and slots together
+		size_t nrCtrlWords = nrGroupsPowerOf2 * c_rFlatCtrlWordsPerGroup;
+		size_t nrSlots = nrGroupsPowerOf2 * c_rFlatGroupSize;
+		size_t allocSize = sizeof(RFlatTableCore::SlotsInfo) +
+											 nrCtrlWords * sizeof(std::atomic<uint64_t>) + nrSlots * sizeof(RFlatSlot);
+		void* p = malloc(allocSize);
+
+		RFlatTableCore::SlotsInfo* pInfo = new (p) RFlatTableCore::SlotsInfo();
+		pInfo->nrGroupsPowerOf2 = nrGroupsPowerOf2;
+
+		char* pCtrlChar = (char*)p + sizeof(RFlatTableCore::SlotsInfo);
+		pInfo->pCtrlWords = new (pCtrlChar) std::atomic<uint64_t>[nrCtrlWords];
+		char* pSlotsChar = pCtrlChar + nrCtrlWords * sizeof(std::atomic<uint64_t>);
+		pInfo->pSlots = new (pSlotsChar) RFlatSlot[nrSlots];
+
+		constexpr uint64_t c_allEmpty = 0x0101010101010101ull * c_rFlatCtrlEmpty;
+		for (size_t iWord = 0; iWord < nrCtrlWords; ++iWord)
+			pInfo->pCtrlWords[iWord].store(c_allEmpty, std::memory_order_relaxed);
+		return pInfo;
+	}
+
+	void destroyAndFreeSlots(RFlatTableCore::SlotsInfo* p)
+	{
+		static_assert(std::is_trivially_destructible_v<RFlatSlot>);
+		static_assert(std::is_trivially_destructible_v<RFlatTableCore::SlotsInfo>);
+		free(p);
+	}
+
+	// writer only: update one control byte and publish it with the whole word
+	void storeCtrl(RFlatTableCore::SlotsInfo* pInfo, size_t slotId, uint8_t ctrl)
+	{
+		std::atomic<uint64_t>& word = pInfo->pCtrlWords[slotId / sizeof(uint64_t)];
+		int shift = 8 * (int)(slotId % sizeof(uint64_t));
+		uint64_t w = word.load(std::memory_order_relaxed);
+		w = (w & ~(0xFFull << shift)) | ((uint64_t)ctrl << shift);
+		word.store(w, std::memory_order_release);
+	}
+
+	constexpr size_t c_noSlot = ~size_t(0);
+
+	struct WriterProbeResult
+	{
+		// slot holding the key
+		size_t foundSlot = c_noSlot;
+		// first empty or deleted slot on the probe sequence
+		size_t freeSlot = c_noSlot;
+	};
+
+	WriterProbeResult
+	probeForWrite(const RFlatTableCore::SlotsInfo* pInfo, uint64_t mixedHash, uint64_t key)
+	{
+		WriterProbeResult res;
+		uint8_t ctrl = rFlatTableDetail::ctrlOfHash(mixedHash);
+		size_t groupMask = pInfo->nrGroupsPowerOf2 - 1;
+		size_t groupId = rFlatTableDetail::firstGroupOfHash(mixedHash, groupMask);
+		for (size_t iProbe = 0; iProbe <= groupMask; ++iProbe)
+		{
+			rFlatTableDetail::GroupCtrls group =
+					rFlatTableDetail::loadGroup(pInfo->pCtrlWords + groupId * c_rFlatCtrlWordsPerGroup);
+			size_t groupStart = groupId * c_rFlatGroupSize;
+			for (uint32_t match = rFlatTableDetail::matchGroup(group, ctrl); match != 0;
+					 match &= match - 1)
+			{
+				size_t slotId = groupStart + std::countr_zero(match);
+				if (pInfo->pSlots[slotId].key.load(std::memory_order_relaxed) == key)
+				{
+					res.foundSlot = slotId;
+					return res;
+				}
+			}
+			uint32_t emptyMask = rFlatTableDetail::matchGroup(group, c_rFlatCtrlEmpty);
+			if (res.freeSlot == c_noSlot)
+			{
+				uint32_t freeMask = emptyMask | rFlatTableDetail::matchGroup(group, c_rFlatCtrlDeleted);
+				if (freeMask)
+					res.freeSlot = groupStart + std::countr_zero(freeMask);
+			}
+			if (emptyMask)
+				return res;
+			groupId = (groupId + iProbe + 1) & groupMask;
+		}
+		return res;
+	}
+
+	// caller makes sure that the slot is not visible to any reader(empty, or deleted slot that
+	// has passed a grace period)
+	void fillSlot(
+			RFlatTableCore::SlotsInfo* pInfo,
+			size_t slotId,
+			uint64_t mixedHash,
+			uint64_t key,
+			void* pValue)
+	{
+		// order matters: readers only look at the slot after they see the control byte
+		pInfo->pSlots[slotId].key.store(key, std::memory_order_relaxed);
+		pInfo->pSlots[slotId].pValue.store(pValue, std::memory_order_relaxed);
+		storeCtrl(pInfo, slotId, rFlatTableDetail::ctrlOfHash(mixedHash));
+	}
+
+	RFlatTableCore::SlotsInfo* rehashReturnOld(RFlatTableCore& table, size_t nrSlotsRequested)
+	{
+		auto* pInfoOld = table.pSlotsInfo.load(std::memory_order_relaxed);
+		size_t size = table.size.load(std::memory_order_relaxed);
+		size_t nrGroups =
+				upperBoundPowerOf2((nrSlotsRequested + c_rFlatGroupSize - 1) / c_rFlatGroupSize);
+		// always leave room for at least one insert
+		while ((float)(size + 1) > table.maxLoadFactor * float(nrGroups * c_rFlatGroupSize))
+			nrGroups *= 2;
+
+		// the new slots are not visible to any reader before publishing
+		RFlatTableCore::SlotsInfo* pInfoNew = allocateAndInitSlots(nrGroups);
+		for (size_t iSlot = 0; iSlot < nrSlotsOf(pInfoOld); ++iSlot)
+		{
+			if (rFlatTableDetail::loadCtrl(pInfoOld, iSlot) & 0x80)
+				continue;	 // empty, deleted or retired
+			const RFlatSlot& slot = pInfoOld->pSlots[iSlot];
+			uint64_t key = slot.key.load(std::memory_order_relaxed);
+			uint64_t mixedHash = rFlatTableDetail::mixHash(key);
+			WriterProbeResult res = probeForWrite(pInfoNew, mixedHash, key);
+			assert(res.foundSlot == c_noSlot && res.freeSlot != c_noSlot);
+			fillSlot(
+					pInfoNew, res.freeSlot, mixedHash, key, slot.pValue.load(std::memory_order_relaxed));
+		}
+
+		table.pSlotsInfo.store(pInfoNew, std::memory_order_release);
+		table.nrTombstones = 0;
+		// retired slots are left behind in the old slots
+		table.retiredSlots.clear();
+		return pInfoOld;
+	}
+}	 // namespace
+
+void rFlatTableCoreInitDetailed(RFlatTableCore& table, const RFlatTableCoreConfig& conf)
+{
+	size_t nrGroups = upperBoundPowerOf2((conf.nrSlots + c_rFlatGroupSize - 1) / c_rFlatGroupSize);
+	table.maxLoadFactor = conf.maxLoadFactor;
+	table.pSlotsInfo.store(allocateAndInitSlots(nrGroups), std::memory_order_relaxed);
+}
+
+void rFlatTableCoreInit(RFlatTableCore& table)
+{
+	rFlatTableCoreInitDetailed(table, RFlatTableCoreConfig{});
+}
+
+void rFlatTableCoreRehash(RFlatTableCore& table, RCUZone& zone, size_t nrSlots)
+{
+	auto* pInfoOld = rehashReturnOld(table, nrSlots);
+	// synchronize so that no one is reading the old slots
+	rcuSynchronize(zone);
+	destroyAndFreeSlots(pInfoOld);
+}
+
+bool rFlatTableCoreTryInsert(RFlatTableCore& table, RCUZone& zone, uint64_t key, void* pValue)
+{
+	RFlatTableCore::SlotsInfo* pInfo = table.pSlotsInfo.load(std::memory_order_relaxed);
+	uint64_t mixedHash = rFlatTableDetail::mixHash(key);
+	WriterProbeResult res = probeForWrite(pInfo, mixedHash, key);
+	if (res.foundSlot != c_noSlot)
+		return false;
+
+	size_t size = table.size.load(std::memory_order_relaxed);
+	size_t nrSlots = nrSlotsOf(pInfo);
+	bool reuseTombstone =
+			res.freeSlot != c_noSlot &&
+			rFlatTableDetail::loadCtrl(pInfo, res.freeSlot) == c_rFlatCtrlDeleted;
+	size_t nrUsedAfter = size + table.nrTombstones + (reuseTombstone ? 0 : 1);
+	if (res.freeSlot == c_noSlot || (float)nrUsedAfter > table.maxLoadFactor * float(nrSlots))
+	{
+		// grow if live elements alone are over half the max load, otherwise only drop tombstones
+		bool grow = (float)(size + 1) > table.maxLoadFactor * float(nrSlots) / 2;
+		rFlatTableCoreRehash(table, zone, grow ? nrSlots * 2 : nrSlots);
+		pInfo = table.pSlotsInfo.load(std::memory_order_relaxed);
+		res = probeForWrite(pInfo, mixedHash, key);
+		reuseTombstone = false;
+	}
+
+	if (reuseTombstone)
+		--table.nrTombstones;
+	fillSlot(pInfo, res.freeSlot, mixedHash, key, pValue);
+	table.size.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void* rFlatTableCoreTryDetachNoSynchronize(RFlatTableCore& table, uint64_t key)
+{
+	RFlatTableCore::SlotsInfo* pInfo = table.pSlotsInfo.load(std::memory_order_relaxed);
+	WriterProbeResult res = probeForWrite(pInfo, rFlatTableDetail::mixHash(key), key);
+	if (res.foundSlot == c_noSlot)
+		return nullptr;
+	void* pValue = pInfo->pSlots[res.foundSlot].pValue.load(std::memory_order_relaxed);
+	// readers might still be reading the slot, it is not reusable before a grace period
+	storeCtrl(pInfo, res.foundSlot, c_rFlatCtrlRetired);
+	table.retiredSlots.push_back(res.foundSlot);
+	++table.nrTombstones;
+	table.size.fetch_sub(1, std::memory_order_relaxed);
+	return pValue;
+}
+
+void rFlatTableCoreSynchronize(RFlatTableCore& table, RCUZone& zone)
+{
+	rcuSynchronize(zone);
+	RFlatTableCore::SlotsInfo* pInfo = table.pSlotsInfo.load(std::memory_order_relaxed);
+	for (size_t slotId : table.retiredSlots)
+		storeCtrl(pInfo, slotId, c_rFlatCtrlDeleted);
+	table.retiredSlots.clear();
+}
+
+void* rFlatTableCoreTryDetachAndSynchronize(RFlatTableCore& table, RCUZone& zone, uint64_t key)
+{
+	void* pValue = rFlatTableCoreTryDetachNoSynchronize(table, key);
+	if (pValue)
+		rFlatTableCoreSynchronize(table, zone);
+	return pValue;
+}
+
+void rFlatTableInit(RFlatTable& table, size_t nrSlots)
+{
+	rcuInitZoneWithBucketCounts(table.rcuZone, std::thread::hardware_concurrency() * 64);
+	RFlatTableCoreConfig conf;
+	conf.nrSlots = nrSlots;
+	rFlatTableCoreInitDetailed(table.core, conf);
+}
+
+int64_t rFlatTableReadLock(RFlatTable& table)
+{
+	return rcuReadLock(table.rcuZone);
+}
+
+void rFlatTableReadUnlock(RFlatTable& table, int64_t epoch)
+{
+	rcuReadUnlock(table.rcuZone, epoch);
+}
+
+bool rFlatTableTryInsert(RFlatTable& table, uint64_t key, void* pValue)
+{
+	return rFlatTableCoreTryInsert(table.core, table.rcuZone, key, pValue);
+}
+
+void* rFlatTableTryDetachNoSynchronize(RFlatTable& table, uint64_t key)
+{
+	return rFlatTableCoreTryDetachNoSynchronize(table.core, key);
+}
+
+void rFlatTableSynchronize(RFlatTable& table)
+{
+	rFlatTableCoreSynchronize(table.core, table.rcuZone);
+}
+
+void* rFlatTableTryDetachAndSynchronize(RFlatTable& table, uint64_t key)
+{
+	return rFlatTableCoreTryDetachAndSynchronize(table.core, table.rcuZone, key);
+}
+
+RFlatTableCore::~RFlatTableCore()
+{
+	auto* p = pSlotsInfo.load();
+	if (p)
+		destroyAndFreeSlots(p);
+}
+}	 // namespace yrcu
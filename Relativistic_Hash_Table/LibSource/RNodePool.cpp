@@ -0,0 +1,142 @@
+#include <functional>
+#include <new>
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RNodePoolApi.h"
+#include "include/RNodePoolTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	thread_local size_t tlsThreadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+	size_t upperBoundPowerOf2(size_t v)
+	{
+		size_t r = 1;
+		while (r < v)
+			r <<= 1;
+		return r;
+	}
+
+	struct CacheLockGuard
+	{
+		explicit CacheLockGuard(RNodePoolCache& c) : cache{ c }
+		{
+			while (cache.locked.exchange(true, std::memory_order_acquire))
+				while (cache.locked.load(std::memory_order_relaxed))
+					std::this_thread::yield();
+		}
+		~CacheLockGuard()
+		{
+			cache.locked.store(false, std::memory_order_release);
+		}
+		RNodePoolCache& cache;
+	};
+
+	RNodePoolCache& threadCache(RNodePool& pool)
+	{
+		return pool.pCaches[tlsThreadHash & (pool.nrCachesPowerOf2 - 1)];
+	}
+
+	// move the drained retire batches to the free list, returns if any slot became free
+	bool recycleDrained(RNodePool& pool, RNodePoolCache& cache)
+	{
+		size_t nrDrained = 0;
+		for (; nrDrained < cache.retireBatches.size(); ++nrDrained)
+		{
+			RNodePoolRetireBatch& batch = cache.retireBatches[nrDrained];
+			if (!rcuIfEpochDrained(*pool.pZone, batch.epoch))
+				break;
+			for (void* p : batch.slots)
+			{
+				RNodePoolFreeSlot* pSlot = (RNodePoolFreeSlot*)p;
+				pSlot->pNext = cache.pFree;
+				cache.pFree = pSlot;
+			}
+		}
+		cache.retireBatches.erase(cache.retireBatches.begin(), cache.retireBatches.begin() + nrDrained);
+		return nrDrained != 0;
+	}
+
+	void addSlab(RNodePool& pool, RNodePoolCache& cache)
+	{
+		size_t slabSize = pool.slotSize * pool.nrSlotsPerSlab;
+		char* pSlab = (char*)::operator new(slabSize, std::align_val_t{ c_rNodePoolSlotAlignment });
+		cache.slabs.push_back(pSlab);
+		cache.pSlabCursor = pSlab;
+		cache.pSlabEnd = pSlab + slabSize;
+	}
+}	 // namespace
+
+void rNodePoolInitDetailed(RNodePool& pool, RCUZone& zone, const RNodePoolConfig& conf)
+{
+	pool.pZone = &zone;
+	pool.slotSize = (conf.nodeSize + c_rNodePoolSlotAlignment - 1) / c_rNodePoolSlotAlignment *
+									c_rNodePoolSlotAlignment;
+	if (pool.slotSize == 0)
+		pool.slotSize = c_rNodePoolSlotAlignment;
+	pool.nrSlotsPerSlab = conf.nrSlotsPerSlab == 0 ? 1 : conf.nrSlotsPerSlab;
+	size_t nrCaches = conf.nrCaches > 0 ? conf.nrCaches : std::thread::hardware_concurrency();
+	pool.nrCachesPowerOf2 = upperBoundPowerOf2(nrCaches);
+	pool.pCaches = new RNodePoolCache[pool.nrCachesPowerOf2];
+}
+
+void rNodePoolInit(RNodePool& pool, RCUZone& zone, size_t nodeSize)
+{
+	RNodePoolConfig conf;
+	conf.nodeSize = nodeSize;
+	rNodePoolInitDetailed(pool, zone, conf);
+}
+
+void* rNodePoolAllocate(RNodePool& pool)
+{
+	RNodePoolCache& cache = threadCache(pool);
+	CacheLockGuard l{ cache };
+	if (cache.pFree == nullptr)
+		recycleDrained(pool, cache);
+	if (cache.pFree != nullptr)
+	{
+		RNodePoolFreeSlot* pSlot = cache.pFree;
+		cache.pFree = pSlot->pNext;
+		return pSlot;
+	}
+	if (cache.pSlabCursor == cache.pSlabEnd)
+		addSlab(pool, cache);
+	void* p = cache.pSlabCursor;
+	cache.pSlabCursor += pool.slotSize;
+	return p;
+}
+
+void rNodePoolFree(RNodePool& pool, void* p)
+{
+	RNodePoolCache& cache = threadCache(pool);
+	RNodePoolFreeSlot* pSlot = (RNodePoolFreeSlot*)p;
+	CacheLockGuard l{ cache };
+	pSlot->pNext = cache.pFree;
+	cache.pFree = pSlot;
+}
+
+void rNodePoolRetire(RNodePool& pool, void* p)
+{
+	// the epoch is read after the node got unlinked, any reader still seeing the node is in this
+	// epoch or an earlier one
+	int64_t epoch = rcuCurrentEpoch(*pool.pZone);
+	RNodePoolCache& cache = threadCache(pool);
+	CacheLockGuard l{ cache };
+	// another thread might have pushed a batch of a later epoch meanwhile, joining it only
+	// delays the reuse
+	if (cache.retireBatches.empty() || cache.retireBatches.back().epoch < epoch)
+		cache.retireBatches.push_back(RNodePoolRetireBatch{ epoch, {} });
+	cache.retireBatches.back().slots.push_back(p);
+}
+
+RNodePool::~RNodePool()
+{
+	for (size_t iCache = 0; iCache < nrCachesPowerOf2; ++iCache)
+		for (void* pSlab : pCaches[iCache].slabs)
+			::operator delete(pSlab, std::align_val_t{ c_rNodePoolSlotAlignment });
+	delete[] pCaches;
+}
+}	 // namespace yrcu
@@ -0,0 +1,67 @@
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RCUHashTableCoreApi.h"
+#include "include/RShardedTableApi.h"
+#include "include/RShardedTableTypes.h"
+
+namespace yrcu
+{
+void rShardedTableInitDetailed(RShardedTable& table, const RShardedTableConfig& conf)
+{
+	rcuInitZoneWithBucketCounts(table.rcuZone, conf.nrRcuBucketsForUnregisteredThreads);
+	table.nrShardBits = conf.nrShardBits;
+	table.pShards = new RTableShard[rShardedTableNrShards(table)];
+	RTableCoreConfig confCore;
+	confCore.expandFactor = conf.expandFactor;
+	confCore.nrBuckets = conf.nrBucketsPerShard;
+	confCore.shrinkFactor = conf.shrinkFactor;
+	for (size_t iShard = 0; iShard < rShardedTableNrShards(table); ++iShard)
+		rTableCoreInitDetailed(table.pShards[iShard].core, confCore);
+}
+
+void rShardedTableInit(RShardedTable& table, int nrShardBits)
+{
+	RShardedTableConfig conf;
+	conf.nrShardBits = nrShardBits;
+	conf.nrRcuBucketsForUnregisteredThreads = std::thread::hardware_concurrency() * 64;
+	rShardedTableInitDetailed(table, conf);
+}
+
+int64_t rShardedTableReadLock(RShardedTable& table)
+{
+	return rcuReadLock(table.rcuZone);
+}
+
+void rShardedTableReadUnlock(RShardedTable& table, int64_t epoch)
+{
+	rcuReadUnlock(table.rcuZone, epoch);
+}
+
+void rShardedTableExpandShard2x(RShardedTable& table, size_t shardId)
+{
+	RTableShard& shard = table.pShards[shardId];
+	std::lock_guard<std::mutex> l{ shard.writerMutex };
+	rTableCoreExpandBuckets2x(shard.core, table.rcuZone);
+}
+
+bool rShardedTableShrinkShard2x(RShardedTable& table, size_t shardId)
+{
+	RTableShard& shard = table.pShards[shardId];
+	std::lock_guard<std::mutex> l{ shard.writerMutex };
+	return rTableCoreShrinkBuckets2x(shard.core, table.rcuZone);
+}
+
+size_t rShardedTableSize(const RShardedTable& table)
+{
+	size_t size = 0;
+	for (size_t iShard = 0; iShard < rShardedTableNrShards(table); ++iShard)
+		size += table.pShards[iShard].core.size.load(std::memory_order_relaxed);
+	return size;
+}
+
+RShardedTable::~RShardedTable()
+{
+	delete[] pShards;
+}
+}	 // namespace yrcu
@@ -0,0 +1,98 @@
+#include <bit>
+
+#include "include/RCUApi.h"
+#include "include/RSkipListApi.h"
+#include "include/RSkipListTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	// 1 + number of trailing zero bit pairs: every level has a quarter of the nodes of the level
+	// below, like the branching of LevelDB
+	int randomLevels(RSkipList& list)
+	{
+		uint64_t x = list.rngState;
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		list.rngState = x;
+		int nrLevels = 1 + std::countr_zero(x) / 2;
+		return nrLevels < c_rSkipListMaxLevels ? nrLevels : c_rSkipListMaxLevels;
+	}
+}	 // namespace
+
+namespace rSkipListDetail
+{
+	void link(RSkipList& list, RSkipNode* pNode, RSkipLink** preds)
+	{
+		int nrLevels = randomLevels(list);
+		int nrLevelsInUse = list.nrLevels.load(std::memory_order_relaxed);
+		for (int level = nrLevelsInUse; level < nrLevels; ++level)
+			preds[level] = &list.heads[level];
+		pNode->nrLevels = nrLevels;
+		pNode->pUpperLinks = nrLevels > 1 ? new RSkipLink[nrLevels - 1] : nullptr;
+		// bottom up: a reader finding the node on a level also finds it on all the levels below
+		for (int level = 0; level < nrLevels; ++level)
+		{
+			RSkipLink* pLink = linkOf(list, pNode, level);
+			pLink->pNode = pNode;
+			rcuSlistInsertAfter(&preds[level]->head, &pLink->head);
+		}
+		if (nrLevels > nrLevelsInUse)
+			list.nrLevels.store(nrLevels, std::memory_order_release);
+		list.size.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void unlink(RSkipList& list, RSkipNode* pNode, RSkipLink** preds)
+	{
+		// top down, the links of the node itself stay intact for the readers standing on it
+		for (int level = pNode->nrLevels - 1; level >= 0; --level)
+		{
+			RSkipLink* pLink = linkOf(list, pNode, level);
+			preds[level]->head.next.store(
+					pLink->head.next.load(std::memory_order_relaxed), std::memory_order_release);
+		}
+		list.size.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void freeTower(RSkipNode* pNode)
+	{
+		delete[] pNode->pUpperLinks;
+		pNode->pUpperLinks = nullptr;
+	}
+}	 // namespace rSkipListDetail
+
+RSkipList::~RSkipList()
+{
+	RcuSlistHead* p = heads[0].head.next.load();
+	while (p != nullptr)
+	{
+		RSkipNode* pNode = YJ_CONTAINER_OF(p, RSkipLink, head)->pNode;
+		p = p->next.load();
+		rSkipListDetail::freeTower(pNode);
+	}
+}
+
+void rSkipListInit(RSkipList& list, int nrRcuBucketsForUnregisteredThreads)
+{
+	rcuInitZoneWithBucketCounts(list.rcuZone, nrRcuBucketsForUnregisteredThreads);
+	for (RSkipLink& head : list.heads)
+	{
+		head.head.next.store(nullptr, std::memory_order_relaxed);
+		head.pNode = nullptr;
+	}
+	list.nrLevels.store(1, std::memory_order_relaxed);
+	list.size.store(0, std::memory_order_relaxed);
+}
+
+int64_t rSkipListReadLock(RSkipList& list)
+{
+	return rcuReadLock(list.rcuZone);
+}
+
+void rSkipListReadUnlock(RSkipList& list, int64_t epoch)
+{
+	rcuReadUnlock(list.rcuZone, epoch);
+}
+}	 // namespace yrcu
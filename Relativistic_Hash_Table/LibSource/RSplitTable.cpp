@@ -0,0 +1,136 @@
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RSplitTableApi.h"
+#include "include/RSplitTableTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	size_t upperBoundPowerOf2(size_t v)
+	{
+		size_t r = 1;
+		while (r < v)
+			r <<= 1;
+		return r;
+	}
+
+	size_t segmentSize(size_t segment)
+	{
+		return segment == 0 ? c_rSplitFirstSegmentSize : c_rSplitFirstSegmentSize << (segment - 1);
+	}
+
+	void allocateSegment(RSplitTableCore& table, size_t segment)
+	{
+		// value initialized: no dummy yet
+		auto* pSegment = new std::atomic<RSplitNode*>[segmentSize(segment)]();
+		table.pSegments[segment].store(pSegment, std::memory_order_release);
+	}
+
+	std::atomic<RSplitNode*>& bucketSlot(RSplitTableCore& table, size_t bucket)
+	{
+		size_t segment = rSplitTableDetail::segmentOfBucket(bucket);
+		return table.pSegments[segment].load(std::memory_order_relaxed)
+				[bucket - rSplitTableDetail::segmentBase(segment)];
+	}
+}	 // namespace
+
+namespace rSplitTableDetail
+{
+	RSplitNode* initializedBucketStart(RSplitTableCore& table, size_t bucket)
+	{
+		std::atomic<RSplitNode*>& slot = bucketSlot(table, bucket);
+		RSplitNode* pDummy = slot.load(std::memory_order_relaxed);
+		if (pDummy != nullptr)
+			return pDummy;
+
+		RSplitNode* pParent = initializedBucketStart(table, parentBucket(bucket));
+		pDummy = new RSplitNode;
+		pDummy->soKey = dummyKey(bucket);
+		RcuSlistHead* pPrev = &pParent->head;
+		for (RcuSlistHead* p = pPrev->next.load(std::memory_order_relaxed); p != nullptr;
+				 p = p->next.load(std::memory_order_relaxed))
+		{
+			if (YJ_CONTAINER_OF(p, RSplitNode, head)->soKey > pDummy->soKey)
+				break;
+			pPrev = p;
+		}
+		// link first, then publish the shortcut: readers reaching the dummy either way see it
+		// inside the sorted list
+		rcuSlistInsertAfter(pPrev, &pDummy->head);
+		slot.store(pDummy, std::memory_order_release);
+		return pDummy;
+	}
+
+	void expandIfNecessary(RSplitTableCore& table, size_t nrElements)
+	{
+		size_t nrBuckets = table.nrBucketsPowerOf2.load(std::memory_order_relaxed);
+		if ((float)nrElements > table.expandFactor * float(nrBuckets))
+			rSplitTableCoreExpandBuckets2x(table);
+	}
+}	 // namespace rSplitTableDetail
+
+void rSplitTableCoreExpandBuckets2x(RSplitTableCore& table)
+{
+	size_t nrBuckets = table.nrBucketsPowerOf2.load(std::memory_order_relaxed);
+	size_t segment = rSplitTableDetail::segmentOfBucket(nrBuckets);
+	if (segment >= c_rSplitMaxSegments)
+		return;
+	if (table.pSegments[segment].load(std::memory_order_relaxed) == nullptr)
+		allocateSegment(table, segment);
+	// the new buckets start uninitialized, readers use their parents meanwhile
+	table.nrBucketsPowerOf2.store(nrBuckets * 2, std::memory_order_release);
+}
+
+void rSplitTableCoreInitDetailed(RSplitTableCore& table, const RSplitTableCoreConfig& conf)
+{
+	size_t nrBuckets = upperBoundPowerOf2(conf.nrBuckets > 0 ? conf.nrBuckets : 1);
+	size_t lastSegment = rSplitTableDetail::segmentOfBucket(nrBuckets - 1);
+	for (size_t segment = 0; segment <= lastSegment; ++segment)
+		allocateSegment(table, segment);
+	RSplitNode* pDummy0 = new RSplitNode;
+	pDummy0->soKey = rSplitTableDetail::dummyKey(0);
+	pDummy0->head.next.store(nullptr, std::memory_order_relaxed);
+	bucketSlot(table, 0).store(pDummy0, std::memory_order_release);
+	table.expandFactor = conf.expandFactor;
+	table.nrBucketsPowerOf2.store(nrBuckets, std::memory_order_release);
+}
+
+void rSplitTableCoreInit(RSplitTableCore& table, int nrBuckets)
+{
+	RSplitTableCoreConfig conf;
+	conf.nrBuckets = nrBuckets;
+	rSplitTableCoreInitDetailed(table, conf);
+}
+
+RSplitTableCore::~RSplitTableCore()
+{
+	// every dummy is referenced by exactly one bucket, the user nodes might be gone already
+	for (size_t segment = 0; segment < c_rSplitMaxSegments; ++segment)
+	{
+		std::atomic<RSplitNode*>* pSegment = pSegments[segment].load();
+		if (pSegment == nullptr)
+			continue;
+		for (size_t i = 0; i < segmentSize(segment); ++i)
+			delete pSegment[i].load();
+		delete[] pSegment;
+	}
+}
+
+void rSplitTableInit(RSplitTable& table, int nrBuckets)
+{
+	rcuInitZoneWithBucketCounts(table.rcuZone, std::thread::hardware_concurrency() * 64);
+	rSplitTableCoreInit(table.core, nrBuckets);
+}
+
+int64_t rSplitTableReadLock(RSplitTable& table)
+{
+	return rcuReadLock(table.rcuZone);
+}
+
+void rSplitTableReadUnlock(RSplitTable& table, int64_t epoch)
+{
+	rcuReadUnlock(table.rcuZone, epoch);
+}
+}	 // namespace yrcu
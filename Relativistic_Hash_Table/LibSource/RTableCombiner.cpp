@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <thread>
+
+#include "include/RCUApi.h"
+#include "include/RCUHashTableCoreApi.h"
+#include "include/RTableCombinerApi.h"
+#include "include/RTableCombinerTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	void expandToFit(RTableCore& table, RCUZone& zone)
+	{
+		for (;;)
+		{
+			size_t nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+			size_t nrElements = table.size.load(std::memory_order_relaxed);
+			if ((float)nrElements <= table.expandFactor * float(nrBuckets))
+				return;
+			rTableCoreExpandBuckets2x(table, zone);
+		}
+	}
+
+	void applyBatch(RTableCombiner& comb, RTableCombinedOp* pList)
+	{
+		RTableCore& table = comb.pTable->core;
+		RCUZone& zone = comb.pTable->rcuZone;
+		std::vector<RTableCombinedOp*>& batch = comb.batch;
+		batch.clear();
+		for (RTableCombinedOp* pOp = pList; pOp; pOp = pOp->pNext)
+		{
+			pOp->bucketHash = rTableCoreDetail::bucketHash(table, pOp->hashVal);
+			batch.push_back(pOp);
+		}
+		// the stack is LIFO, restore the posting order and keep it for the operations of one key
+		// (they share the bucket) with a stable sort
+		std::reverse(batch.begin(), batch.end());
+		size_t mask = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2 - 1;
+		std::stable_sort(
+				batch.begin(),
+				batch.end(),
+				[mask](const RTableCombinedOp* p0, const RTableCombinedOp* p1)
+				{ return (p0->bucketHash & mask) < (p1->bucketHash & mask); });
+
+		size_t nrInserted = 0;
+		size_t nrDetached = 0;
+		for (RTableCombinedOp* pOp : batch)
+		{
+			RTableCombinerMatchFn matchFn = comb.matchFn;
+			const void* pKey = pOp->pKey;
+			auto predict = [matchFn, pKey](const RNode* p)
+			{ return matchFn(p, pKey); };
+			switch (pOp->type)
+			{
+			case RTableCombinedOpType::Insert:
+			{
+				auto binaryPredict = [matchFn, pKey](const RNode* pExisting, const RNode*)
+				{ return matchFn(pExisting, pKey); };
+				bool inserted =
+						rTableCoreTryInsertNoExpand(table, pOp->pNode, pOp->hashVal, binaryPredict);
+				pOp->pResult = inserted ? pOp->pNode : nullptr;
+				nrInserted += inserted;
+				break;
+			}
+			case RTableCombinedOpType::Erase:
+				pOp->pResult = rTableCoreTryDetachNoShrink(table, pOp->hashVal, predict);
+				nrDetached += pOp->pResult != nullptr;
+				break;
+			case RTableCombinedOpType::Replace:
+				pOp->pResult = rTableCoreReplace(table, pOp->hashVal, predict, pOp->pNode);
+				nrDetached += pOp->pResult != nullptr;
+				break;
+			}
+		}
+
+		// one resize check and one grace period for the whole batch
+		if (nrInserted > 0)
+			expandToFit(table, zone);
+		if (nrDetached > 0 && !rTableCoreDetail::shrinkBucketsToFit(table, zone))
+			rcuSynchronize(zone);
+		comb.nrBatches.fetch_add(1, std::memory_order_relaxed);
+		comb.nrCombinedOps.fetch_add(batch.size(), std::memory_order_relaxed);
+		// the producers might free their op as soon as done is set
+		for (RTableCombinedOp* pOp : batch)
+			pOp->done.store(true, std::memory_order_release);
+		batch.clear();
+	}
+
+	RNode* postAndWait(
+			RTableCombiner& comb,
+			RTableCombinedOpType type,
+			size_t hashVal,
+			const void* pKey,
+			RNode* pNode)
+	{
+		RTableCombinedOp op;
+		op.type = type;
+		op.hashVal = hashVal;
+		op.pKey = pKey;
+		op.pNode = pNode;
+		rTableCombinerPost(comb, op);
+		rTableCombinerWait(comb, op);
+		return op.pResult;
+	}
+}	 // namespace
+
+void rTableCombinerInit(RTableCombiner& comb, RTable& table, RTableCombinerMatchFn matchFn)
+{
+	comb.pTable = &table;
+	comb.matchFn = matchFn;
+}
+
+void rTableCombinerPost(RTableCombiner& comb, RTableCombinedOp& op)
+{
+	op.done.store(false, std::memory_order_relaxed);
+	RTableCombinedOp* pHead = comb.pPending.load(std::memory_order_relaxed);
+	do
+		op.pNext = pHead;
+	while (!comb.pPending.compare_exchange_weak(
+			pHead, &op, std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool rTableCombinerTryCombine(RTableCombiner& comb)
+{
+	if (comb.combining.load(std::memory_order_relaxed) ||
+			comb.combining.exchange(true, std::memory_order_acquire))
+		return false;
+	// taking the whole stack at once, so no ABA problem for the producers' pushes
+	RTableCombinedOp* pList = comb.pPending.exchange(nullptr, std::memory_order_acquire);
+	if (pList)
+		applyBatch(comb, pList);
+	comb.combining.store(false, std::memory_order_release);
+	return pList != nullptr;
+}
+
+void rTableCombinerWait(RTableCombiner& comb, RTableCombinedOp& op)
+{
+	while (!op.done.load(std::memory_order_acquire))
+		if (!rTableCombinerTryCombine(comb))
+			// the combiner might be waiting for a grace period
+			std::this_thread::yield();
+}
+
+bool rTableCombinerTryInsert(
+		RTableCombiner& comb,
+		RNode* pEntry,
+		size_t hashVal,
+		const void* pKey)
+{
+	return postAndWait(comb, RTableCombinedOpType::Insert, hashVal, pKey, pEntry) != nullptr;
+}
+
+RNode* rTableCombinerTryDetachAndSynchronize(
+		RTableCombiner& comb,
+		size_t hashVal,
+		const void* pKey)
+{
+	return postAndWait(comb, RTableCombinedOpType::Erase, hashVal, pKey, nullptr);
+}
+
+RNode* rTableCombinerReplaceAndSynchronize(
+		RTableCombiner& comb,
+		size_t hashVal,
+		const void* pKey,
+		RNode* pNewEntry)
+{
+	return postAndWait(comb, RTableCombinedOpType::Replace, hashVal, pKey, pNewEntry);
+}
+}	 // namespace yrcu
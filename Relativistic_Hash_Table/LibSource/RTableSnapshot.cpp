@@ -0,0 +1,190 @@
+#include <climits>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "include/RTableSnapshotApi.h"
+#include "include/RTableSnapshotTypes.h"
+
+namespace yrcu
+{
+namespace
+{
+	void writeBytes(RTableSnapshotWriter& writer, const void* p, size_t size)
+	{
+		if (size == 0 || writer.failed)
+			return;
+		if (fwrite(p, 1, size, writer.pFile) != size)
+			writer.failed = true;
+		writer.offset += size;
+	}
+
+	bool validateSnapshot(const char* pData, size_t size)
+	{
+		if (size < sizeof(RTableSnapshotHeader))
+			return false;
+		const RTableSnapshotHeader* pHeader = (const RTableSnapshotHeader*)pData;
+		// the bucket count is passed on as RTableConfig::nrBuckets (an int), and the records and the
+		// chunk index are read in place, so their offsets must be 8 byte aligned
+		if (pHeader->magic != c_rTableSnapshotMagic || pHeader->nrBucketsPowerOf2 == 0 ||
+				(pHeader->nrBucketsPowerOf2 & (pHeader->nrBucketsPowerOf2 - 1)) != 0 ||
+				pHeader->nrBucketsPowerOf2 > (uint64_t)INT_MAX || pHeader->mixHash > 1 ||
+				pHeader->chunkIndexOffset % 8 != 0 ||
+				pHeader->chunkIndexOffset < sizeof(RTableSnapshotHeader) ||
+				pHeader->chunkIndexOffset > size ||
+				pHeader->nrChunks > (size - pHeader->chunkIndexOffset) / sizeof(uint64_t))
+			return false;
+		// chunk offsets must be increasing and inside the records
+		const uint64_t* pChunkOffsets = (const uint64_t*)(pData + pHeader->chunkIndexOffset);
+		uint64_t last = sizeof(RTableSnapshotHeader);
+		for (uint64_t iChunk = 0; iChunk < pHeader->nrChunks; ++iChunk)
+		{
+			if (pChunkOffsets[iChunk] < last || pChunkOffsets[iChunk] > pHeader->chunkIndexOffset ||
+					pChunkOffsets[iChunk] % 8 != 0)
+				return false;
+			last = pChunkOffsets[iChunk];
+		}
+		return true;
+	}
+}	 // namespace
+
+namespace rTableSnapshotDetail
+{
+	bool writerBegin(RTableSnapshotWriter& writer, const char* path)
+	{
+		writer.pFile = fopen(path, "wb");
+		if (writer.pFile == nullptr)
+			return false;
+		// the header is rewritten by writerFinish
+		RTableSnapshotHeader header{};
+		writeBytes(writer, &header, sizeof(header));
+		return !writer.failed;
+	}
+
+	void writerBeginChunk(RTableSnapshotWriter& writer)
+	{
+		writer.chunkOffsets.push_back(writer.offset);
+	}
+
+	void writerAppendRecord(
+			RTableSnapshotWriter& writer,
+			uint64_t hash,
+			const void* pPayload,
+			size_t payloadSize)
+	{
+		RTableSnapshotRecord record{ hash, payloadSize };
+		writeBytes(writer, &record, sizeof(record));
+		writeBytes(writer, pPayload, payloadSize);
+		const char padding[8] = {};
+		writeBytes(writer, padding, recordSize(payloadSize) - sizeof(record) - payloadSize);
+		++writer.nrNodes;
+	}
+
+	bool writerFinish(RTableSnapshotWriter& writer, size_t nrBucketsPowerOf2, bool mixHash)
+	{
+		RTableSnapshotHeader header{};
+		header.magic = c_rTableSnapshotMagic;
+		header.nrBucketsPowerOf2 = nrBucketsPowerOf2;
+		header.nrNodes = writer.nrNodes;
+		header.chunkIndexOffset = writer.offset;
+		header.nrChunks = writer.chunkOffsets.size();
+		header.mixHash = mixHash ? 1 : 0;
+		size_t indexSize = writer.chunkOffsets.size() * sizeof(uint64_t);
+		writeBytes(writer, writer.chunkOffsets.data(), indexSize);
+		if (!writer.failed && fseek(writer.pFile, 0, SEEK_SET) == 0)
+			writeBytes(writer, &header, sizeof(header));
+		else
+			writer.failed = true;
+		if (fclose(writer.pFile) != 0)
+			writer.failed = true;
+		writer.pFile = nullptr;
+		return !writer.failed;
+	}
+
+#ifdef _WIN32
+	bool mapSnapshot(RTableSnapshotMapping& mapping, const char* path)
+	{
+		HANDLE hFile = CreateFileA(
+				path,
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_FLAG_SEQUENTIAL_SCAN,
+				nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size;
+		HANDLE hMapping = nullptr;
+		if (GetFileSizeEx(hFile, &size) && size.QuadPart > 0)
+			hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const char* pData = nullptr;
+		if (hMapping)
+			pData = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		mapping.pData = pData;
+		mapping.size = (size_t)size.QuadPart;
+		mapping.hFile = hFile;
+		mapping.hMapping = hMapping;
+		if (pData == nullptr || !validateSnapshot(pData, mapping.size))
+		{
+			unmapSnapshot(mapping);
+			return false;
+		}
+		return true;
+	}
+
+	void unmapSnapshot(RTableSnapshotMapping& mapping)
+	{
+		if (mapping.pData)
+			UnmapViewOfFile(mapping.pData);
+		if (mapping.hMapping)
+			CloseHandle(mapping.hMapping);
+		if (mapping.hFile)
+			CloseHandle(mapping.hFile);
+		mapping = RTableSnapshotMapping{};
+	}
+#else
+	bool mapSnapshot(RTableSnapshotMapping& mapping, const char* path)
+	{
+		int fd = open(path, O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		void* p = MAP_FAILED;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+			p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		// the mapping keeps the file referenced
+		close(fd);
+		if (p == MAP_FAILED)
+			return false;
+		// the records are read front to back, chunk by chunk
+		madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+		mapping.pData = (const char*)p;
+		mapping.size = (size_t)st.st_size;
+		if (!validateSnapshot(mapping.pData, mapping.size))
+		{
+			unmapSnapshot(mapping);
+			return false;
+		}
+		return true;
+	}
+
+	void unmapSnapshot(RTableSnapshotMapping& mapping)
+	{
+		if (mapping.pData)
+			munmap((void*)mapping.pData, mapping.size);
+		mapping = RTableSnapshotMapping{};
+	}
+#endif
+}	 // namespace rTableSnapshotDetail
+}	 // namespace yrcu
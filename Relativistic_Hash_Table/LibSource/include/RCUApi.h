@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 namespace yrcu
 {
@@ -50,5 +51,13 @@ void rcuReadUnlock(RCUZone& zone, int64_t epoch);
 
 // writer to wait for all on going reader critical sessions
 // before the call to expire
+// Several writer threads might call it concurrently on the same zone.
 void rcuSynchronize(RCUZone& zone);
+
+// For deferred reclamation without waiting:
+// read the current epoch after unlinking a resource, the resource can be freed once
+// rcuIfEpochDrained returns true for the epoch, i.e. after any rcuSynchronize started later
+// on the zone has finished.
+int64_t rcuCurrentEpoch(RCUZone& zone);
+bool rcuIfEpochDrained(RCUZone& zone, int64_t epoch);
 }	 // namespace yrcu
@@ -1,4 +1,6 @@
 #pragma once
+#include <thread>
+
 #include "RCUApi.h"
 #include "RCUHashTableCoreApi.h"
 #include "RCUHashTableTypes.h"
@@ -14,6 +16,19 @@ struct RTableConfig
 	int nrRcuBucketsForUnregisteredThreads = 128;
 	float expandFactor = 1.1f;
 	float shrinkFactor = 0.25f;
+	// 0 disables the concurrent writer mode, see rTableConcurrentTryInsert
+	int nrWriterStripes = 0;
+	// large bucket arrays are mapped by default, 0 disables it, see
+	// RTableCore::bucketsMmapThresholdBytes
+	size_t bucketsMmapThresholdBytes = c_rTableBucketsMmapThresholdBytes;
+	bool bucketsUseHugeTlb = false;
+	bool bucketsInterleaveNuma = false;
+	// see RTableCore::mixHash
+	bool mixHash = false;
+	// bits of the Bloom filter per element, 0 disables it, see RTableCore::pBloom
+	int bloomBitsPerElement = 0;
+	// see RTableCore::handleNodes
+	bool handleNodes = false;
 };
 
 void rTableInitDetailed(RTable& table, const RTableConfig& conf);
@@ -25,7 +40,7 @@ void rTableInitDetailed(RTable& table, const RTableConfig& conf);
 template<typename UnaryPredicate>
 RNode* rTableTryDetachNoShrink(RTable& table, size_t hashVal, UnaryPredicate matchOp)
 {
-	rTableCoreCoreTryDetachNoShrink(table.core, hashVal, std::move(matchOp));
+	return rTableCoreTryDetachNoShrink(table.core, hashVal, std::move(matchOp));
 }
 
 // might shrink automatically
@@ -41,6 +56,15 @@ RNode* rTableTryDetachAutoShrink(
 			table.core, hashVal, matchOp, table.rcuZone, outIfAlreadyRcuSynrhonized);
 }
 
+// Write operation: all writers must be serialized
+// Replaces the node matching matchOp by pNewEntry without a gap for the readers, see
+// rTableCoreReplace. Free the returned node after rTableSynchronize.
+template<typename UnaryPredicate>
+RNode* rTableReplace(RTable& table, size_t hashVal, UnaryPredicate matchOp, RNode* pNewEntry)
+{
+	return rTableCoreReplace(table.core, hashVal, std::move(matchOp), pNewEntry);
+}
+
 template<typename Op>
 bool rTableTryInsertNoExpand(RTable& table, RNode* pEntry, size_t hashVal, Op matchOp)
 {
@@ -51,7 +75,8 @@ bool rTableTryInsertNoExpand(RTable& table, RNode* pEntry, size_t hashVal, Op ma
 // and after the synchronize operation, the detached nodes can be safely freed.
 void rTableSynchronize(RTable& table);
 
-// can only be called if the user is sure that no dup exists
+// can only be called if the user is sure that no dup exists, see rTableCoreInsertNoExpand for
+// pEntry->hash
 void rTableInsertNoExpand(RTable& table, RNode* pEntry);
 
 void rTableExpandBuckets2x(RTable& table);
@@ -104,6 +129,92 @@ RNode* rTableFind(const RTable& table, size_t hashVal, Op matchOp)
 	return rTableCoreFind(table.core, hashVal, matchOp);
 }
 
+// Read operation: rTableFind through a thread_local RTableHotCache, for skewed key
+// distributions, see rTableCoreCachedFind.
+template<typename Op>
+RNode* rTableCachedFind(const RTable& table, RTableHotCache& cache, size_t hashVal, Op matchOp)
+{
+	return rTableCoreCachedFind(table.core, cache, hashVal, matchOp);
+}
+
+// Read operation
+// Calls visitor (void(RNode*)) on all the nodes matching matchOp, for tables filled with
+// rTableInsertMulti, see rTableCoreFindAll.
+template<typename UnaryPredicate, typename Visitor>
+size_t rTableFindAll(const RTable& table, size_t hashVal, UnaryPredicate matchOp, Visitor visitor)
+{
+	return rTableCoreFindAll(table.core, hashVal, matchOp, visitor);
+}
+
+// Read operation, batched rTableFind
+// outNodes[i] receives the node matching (hashVals[i], keys[i]) or nullptr.
+// Op should have function signature of bool(const RNode*, const TKey&).
+// Take one RTableReadLockGuard for the whole batch, the found nodes are only valid inside it.
+template<typename TKey, typename Op>
+void rTableFindBatch(
+		const RTable& table,
+		const size_t* hashVals,
+		const TKey* keys,
+		RNode** outNodes,
+		size_t n,
+		Op matchOp)
+{
+	rTableCoreFindBatch(table.core, hashVals, keys, outNodes, n, matchOp);
+}
+
+// Read operation: takes the read lock itself, see rTableCoreForEach.
+// fn has function signature of void(RNode*), every node is visited once even if the table is
+// resized meanwhile.
+template<typename Fn>
+void rTableForEach(RTable& table, Fn fn)
+{
+	RTableReadLockGuard l(table);
+	rTableCoreForEach(table.core, fn);
+}
+
+// Read operation: takes the read lock itself, see rTableCoreParallelForEach.
+// fn is called concurrently from nrThreads threads.
+template<typename Fn>
+void rTableParallelForEach(
+		RTable& table,
+		Fn fn,
+		size_t nrThreads = std::thread::hardware_concurrency())
+{
+	RTableReadLockGuard l(table);
+	rTableCoreParallelForEach(table.core, fn, nrThreads);
+}
+
+// Read operation: takes the read lock itself, see rTableCoreGetStats.
+RTableStats rTableGetStats(RTable& table, size_t nrSampledBuckets = 0);
+
+// Read operation: takes the read lock for this chunk of `budget` buckets only, so that a long
+// scan does not block the writers. Start with cursor 0 and continue with the returned cursor
+// until it is 0, see rTableCoreScan.
+template<typename Fn>
+size_t rTableScan(RTable& table, size_t cursor, size_t budget, Fn fn)
+{
+	RTableReadLockGuard l(table);
+	return rTableCoreScan(table.core, cursor, budget, fn);
+}
+
+// Write operation: all writers must be serialized
+// Inserts n nodes with their hashes hashVals, at the final bucket count and on nrThreads
+// threads, see rTableCoreBulkInsert. Returns the number of inserted nodes, which are moved to
+// the front of nodes (and their hashes to the front of hashVals).
+template<typename Op>
+size_t rTableBulkInsert(
+		RTable& table,
+		RNode** nodes,
+		size_t* hashVals,
+		size_t n,
+		RTableBulkDupPolicy dupPolicy,
+		Op matchOp,
+		size_t nrThreads = 1)
+{
+	return rTableCoreBulkInsert(
+			table.core, table.rcuZone, nodes, hashVals, n, dupPolicy, matchOp, nrThreads);
+}
+
 // Write operation: all writers must be serialized
 // Op is of function signature of bool(RNode* p0, RcuHashTaleEntry* p1), which
 // returns if two hash table entries are equivalent. Expand if necessary
@@ -113,6 +224,37 @@ bool rTableTryInsert(RTable& table, RNode* pEntry, size_t hashVal, Op matchOp)
 	return rTableCoreTryInsert(table.core, table.rcuZone, pEntry, hashVal, matchOp);
 }
 
+// Write operation: all writers must be serialized
+// Inserts pEntry even if equal nodes exist, adjacent to them, see rTableCoreInsertMulti.
+template<typename UnaryPredicate>
+void rTableInsertMulti(RTable& table, RNode* pEntry, size_t hashVal, UnaryPredicate matchOp)
+{
+	rTableCoreInsertMulti(table.core, table.rcuZone, pEntry, hashVal, matchOp);
+}
+
+// Write operation: all writers must be serialized
+// Returns the node matching matchOp, or inserts the node created by makeNode (RNode*()) on a
+// miss only, in one chain traversal, see rTableCoreFindOrInsert.
+template<typename UnaryPredicate, typename Factory>
+RNode* rTableFindOrInsert(
+		RTable& table,
+		size_t hashVal,
+		UnaryPredicate matchOp,
+		Factory makeNode,
+		bool* outInserted = nullptr)
+{
+	return rTableCoreFindOrInsert(table.core, table.rcuZone, hashVal, matchOp, makeNode, outInserted);
+}
+
+// Write operation: all writers must be serialized
+// Replaces the node matching matchOp by pEntry or inserts pEntry, see rTableCoreUpsert.
+// Free the returned node (if any) after rTableSynchronize.
+template<typename UnaryPredicate>
+RNode* rTableUpsert(RTable& table, RNode* pEntry, size_t hashVal, UnaryPredicate matchOp)
+{
+	return rTableCoreUpsert(table.core, table.rcuZone, pEntry, hashVal, matchOp);
+}
+
 // Write operation: all writers must be serialized
 // Op is of function signature of bool(RNode* p0), which returns if the entry is
 // what you are looking for. rcuSynchronize is called internally and it is safe
@@ -122,4 +264,77 @@ RNode* rTableTryDetachAndSynchronize(RTable& table, size_t hashVal, Op matchOp)
 {
 	return rTableCoreTryDetachAndSynchronize(table.core, table.rcuZone, hashVal, matchOp);
 }
+
+// Write operation: all writers must be serialized
+// Erases every node matching pred in one pass and with one grace period, see rTableCoreEraseIf.
+// disposer (void(RNode*)) frees the nodes after the grace period.
+template<typename UnaryPredicate, typename Disposer>
+size_t rTableEraseIf(RTable& table, UnaryPredicate pred, Disposer disposer)
+{
+	return rTableCoreEraseIf(table.core, table.rcuZone, pred, disposer);
+}
+
+// Write operation: all writers must be serialized
+// Detaches the nodes matching (hashVals[i], keys[i]) with one grace period, see
+// rTableCoreDetachMany.
+template<typename TKey, typename BinaryPredicate, typename Disposer>
+size_t rTableDetachMany(
+		RTable& table,
+		const size_t* hashVals,
+		const TKey* keys,
+		size_t n,
+		BinaryPredicate matchOp,
+		Disposer disposer)
+{
+	return rTableCoreDetachMany(table.core, table.rcuZone, hashVals, keys, n, matchOp, disposer);
+}
+
+// Write operation: all writers must be serialized
+// Erases all the nodes with one grace period, see rTableCoreClear.
+template<typename Disposer>
+size_t rTableClear(RTable& table, Disposer disposer)
+{
+	return rTableCoreClear(table.core, table.rcuZone, disposer);
+}
+
+////////////////////////////////////////////////////////////////
+//--------------------------Handle nodes----------------------//
+////////////////////////////////////////////////////////////////
+// Only for tables initialized with RTableConfig::handleNodes, see rTableCoreDetachNode.
+
+// Write operation: all writers must be serialized
+template<typename Op>
+bool rTableHandleTryInsert(RTable& table, RHandleNode* pEntry, size_t hashVal, Op matchOp)
+{
+	return rTableCoreHandleTryInsert(table.core, table.rcuZone, pEntry, hashVal, matchOp);
+}
+
+// Write operation: all writers must be serialized
+// O(1) unlink of pNode, free it after rTableSynchronize.
+void rTableDetachNode(RTable& table, RHandleNode* pNode);
+
+// Write operation: all writers must be serialized
+// O(1) unlink of pNode, which can be freed on return.
+void rTableDetachNodeAndSynchronize(RTable& table, RHandleNode* pNode);
+
+////////////////////////////////////////////////////////////////
+//-------------------Concurrent writer mode-------------------//
+////////////////////////////////////////////////////////////////
+// Only for tables initialized with RTableConfig::nrWriterStripes > 0.
+// Concurrent writers lock the stripe of their bucket only, and do not need to be serialized
+// with each other. Write throughput scales with the writer threads on disjoint buckets.
+
+// Write operation: concurrent with other concurrent writers
+template<typename Op>
+bool rTableConcurrentTryInsert(RTable& table, RNode* pEntry, size_t hashVal, Op matchOp)
+{
+	return rTableCoreConcurrentTryInsert(table.core, table.rcuZone, pEntry, hashVal, matchOp);
+}
+
+// Write operation: concurrent with other concurrent writers
+template<typename Op>
+RNode* rTableConcurrentTryDetachAndSynchronize(RTable& table, size_t hashVal, Op matchOp)
+{
+	return rTableCoreConcurrentTryDetachAndSynchronize(table.core, table.rcuZone, hashVal, matchOp);
+}
 }	 // namespace yrcu
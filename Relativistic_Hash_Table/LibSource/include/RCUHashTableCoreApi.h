@@ -1,12 +1,108 @@
 #pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <future>
+#include <vector>
+
 #include "RcuSinglyLinkedListApi.h"
 #include "RCUApi.h"
 #include "RCUHashTableTypes.h"
+#include "RHashers.h"
 
 namespace yrcu
 {
 namespace rTableCoreDetail
 {
+	// the hash stored in RNode::hash and used for the bucket selection, see RTableCore::mixHash
+	inline size_t bucketHash(const RTableCore& table, size_t hashVal)
+	{
+		return table.mixHash ? (size_t)rHashMix64(hashVal) : hashVal;
+	}
+
+	inline RTableCore::Bucket* bucketOf(
+			const RTableCore::BucketsInfo* pBucketsInfo,
+			size_t bucketHash)
+	{
+		return pBucketsInfo->pBuckets + (bucketHash & (pBucketsInfo->nrBucketsPowerOf2 - 1));
+	}
+
+	inline void bloomMasks(
+			const RTableBloom* pBloom,
+			size_t bucketHash,
+			size_t& outIBlock,
+			uint64_t (&outMasks)[8])
+	{
+		// split block Bloom filter: the high half picks the block, the low half one bit per word
+		constexpr uint32_t c_salts[8] = { 0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+																			0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+		uint64_t h = rHashMix64(bucketHash);
+		outIBlock = (size_t)(h >> 32) & (pBloom->nrBlocksPowerOf2 - 1);
+		for (int iWord = 0; iWord < 8; ++iWord)
+			outMasks[iWord] = uint64_t(1) << ((uint32_t(h) * c_salts[iWord]) >> 26);
+	}
+
+	// Write operation: also used by the concurrent writers, thus the atomic or
+	inline void bloomAdd(RTableCore& table, size_t bucketHash)
+	{
+		RTableBloom* pBloom = table.pBloom.load(std::memory_order_relaxed);
+		if (!pBloom)
+			return;
+		size_t iBlock;
+		uint64_t masks[8];
+		bloomMasks(pBloom, bucketHash, iBlock, masks);
+		RTableBloomBlock& block = pBloom->pBlocks[iBlock];
+		for (int iWord = 0; iWord < 8; ++iWord)
+			block.words[iWord].fetch_or(masks[iWord], std::memory_order_relaxed);
+	}
+
+	// Write operation: a node left the table, see RTableCore::generation
+	inline void bumpGeneration(RTableCore& table)
+	{
+		table.generation.fetch_add(1, std::memory_order_release);
+	}
+
+	inline void bloomNoteRemoved(RTableCore& table, size_t nrRemoved)
+	{
+		RTableBloom* pBloom = table.pBloom.load(std::memory_order_relaxed);
+		if (pBloom)
+			pBloom->nrRemoved.fetch_add(nrRemoved, std::memory_order_relaxed);
+	}
+
+	// Read operation: false if no node of the hash is in the table
+	inline bool bloomMayContain(const RTableCore& table, size_t bucketHash)
+	{
+		const RTableBloom* pBloom = table.pBloom.load(std::memory_order_acquire);
+		if (!pBloom)
+			return true;
+		size_t iBlock;
+		uint64_t masks[8];
+		bloomMasks(pBloom, bucketHash, iBlock, masks);
+		const RTableBloomBlock& block = pBloom->pBlocks[iBlock];
+		uint64_t missing = 0;
+		for (int iWord = 0; iWord < 8; ++iWord)
+			missing |= masks[iWord] & ~block.words[iWord].load(std::memory_order_relaxed);
+		return missing == 0;
+	}
+
+	// Publishes a filter sized for nrBuckets and holding the nodes of pNodesInfo, and returns the
+	// previous one (or nullptr), to be freed with freeBloom after a grace period.
+	RTableBloom* rebuildBloom(
+			RTableCore& table,
+			const RTableCore::BucketsInfo* pNodesInfo,
+			size_t nrBuckets);
+
+	void freeBloom(RTableBloom* pBloom);
+
+	inline RHandleNode* handleOf(RcuSlistHead* p)
+	{
+		return YJ_CONTAINER_OF(YJ_CONTAINER_OF(p, RNode, head), RHandleNode, node);
+	}
+
+	// sets every back pointer of a table with handle nodes again, after the chains were relinked
+	// wholesale (resizes, loading)
+	void relinkBackPointers(RTableCore& table);
+
 	void expandBucketsByFac2IfNecessary(
 			size_t nrElements,
 			size_t nrBuckets,
@@ -17,6 +113,97 @@ namespace rTableCoreDetail
 			size_t nrBuckets,
 			RTableCore& table,
 			RCUZone& zone);
+
+	// shrinks as long as necessary for the current size, returns if rcuSynchronize was called
+	bool shrinkBucketsToFit(RTableCore& table, RCUZone& zone);
+
+	void lockWriterStripe(RTableCore& table, size_t hashVal);
+	void unlockWriterStripe(RTableCore& table, size_t hashVal);
+
+	// concurrent writer mode versions of the resize checks, they take all the writer stripes
+	// before resizing, and skip if another writer is already resizing
+	void concurrentExpandIfNecessary(
+			size_t nrElements,
+			size_t nrBuckets,
+			RTableCore& table,
+			RCUZone& zone);
+	bool concurrentShrinkIfNecessary(
+			size_t nrElements,
+			size_t nrBuckets,
+			RTableCore& table,
+			RCUZone& zone);
+
+	struct WriterStripeGuard
+	{
+		// the stripe follows the bucket, so it is selected by the (mixed) bucket hash
+		WriterStripeGuard(RTableCore& table, size_t hashVal)
+				: tbl{ table }, hash{ bucketHash(table, hashVal) }
+		{
+			lockWriterStripe(tbl, hash);
+		}
+		WriterStripeGuard(const WriterStripeGuard&) = delete;
+		WriterStripeGuard& operator=(const WriterStripeGuard&) = delete;
+		~WriterStripeGuard()
+		{
+			unlockWriterStripe(tbl, hash);
+		}
+		RTableCore& tbl;
+		size_t hash;
+	};
+
+	// Read operation: visits the nodes belonging to the buckets [iBegin, iEnd) of pInfo.
+	// During a resize a chain might also hold the nodes of its twin bucket (zipped chains of an
+	// expand, spliced chains of a shrink), they are skipped here and visited with their own
+	// bucket, so that every node is visited exactly once per bucket array.
+	template<typename Fn>
+	void forEachInBuckets(
+			const RTableCore::BucketsInfo* pInfo,
+			size_t iBegin,
+			size_t iEnd,
+			Fn& fn)
+	{
+		size_t bucketMask = pInfo->nrBucketsPowerOf2 - 1;
+		for (size_t iBucket = iBegin; iBucket < iEnd; ++iBucket)
+		{
+			RcuSlist* pList = &pInfo->pBuckets[iBucket].list;
+			for (RcuSlistHead* p = pList->head.next.load(std::memory_order_acquire); p != nullptr;
+					 p = p->next.load(std::memory_order_acquire))
+			{
+				RNode* pNode = YJ_CONTAINER_OF(p, RNode, head);
+				if ((pNode->hash & bucketMask) == iBucket)
+					fn(pNode);
+			}
+		}
+	}
+
+	// Bulk insert: returns a bucket array sized for nrElements. If the table is empty, a new
+	// array is allocated but not published yet (outUnpublished), otherwise the table is expanded
+	// to the size.
+	RTableCore::BucketsInfo*
+	bulkReserveBuckets(RTableCore& table, RCUZone& zone, size_t nrElements, bool& outUnpublished);
+	// publishes the filled array and frees the previous one after a grace period
+	void bulkPublishBuckets(RTableCore& table, RCUZone& zone, RTableCore::BucketsInfo* pBucketsInfo);
+
+	struct alignas(64) ForEachCursor
+	{
+		std::atomic<size_t> nextChunk = 0;
+		size_t endChunk = 0;
+	};
+
+	// Reverse binary increment of the bits of bucketMask, the bits above it are dropped.
+	// Buckets are visited in an order where a bucket is followed by the buckets it splits into,
+	// like the SCAN cursor of redis. Returns 0 after the last bucket.
+	inline size_t nextScanCursor(size_t cursor, size_t bucketMask)
+	{
+		cursor &= bucketMask;
+		size_t bit = (bucketMask + 1) >> 1;
+		while ((cursor & bit) != 0)
+		{
+			cursor ^= bit;
+			bit >>= 1;
+		}
+		return cursor | bit;
+	}
 }	 // namespace rTableCoreDetail
 
 //////////////////////////////////////////////
@@ -28,27 +215,107 @@ struct RTableCoreConfig
 	int nrBuckets = 64;
 	float expandFactor = 1.1f;
 	float shrinkFactor = 0.25f;
+	// 0 disables the concurrent writer mode, otherwise rounded up to a power of 2 and used by
+	// rTableCoreConcurrentTryInsert and rTableCoreConcurrentTryDetachAndSynchronize
+	int nrWriterStripes = 0;
+	// large bucket arrays are mapped by default, 0 disables it, see
+	// RTableCore::bucketsMmapThresholdBytes, bucketsUseHugeTlb and bucketsInterleaveNuma
+	size_t bucketsMmapThresholdBytes = c_rTableBucketsMmapThresholdBytes;
+	bool bucketsUseHugeTlb = false;
+	bool bucketsInterleaveNuma = false;
+	// see RTableCore::mixHash
+	bool mixHash = false;
+	// bits of the Bloom filter per element, 0 disables it, see RTableCore::pBloom
+	int bloomBitsPerElement = 0;
+	// see RTableCore::handleNodes
+	bool handleNodes = false;
 };
 
 void rTableCoreInitDetailed(RTableCore& table, const RTableCoreConfig& conf);
 
+constexpr size_t c_rTableStatsNrHistogramBins = 16;
+
+struct RTableStats
+{
+	size_t nrBuckets = 0;
+	size_t size = 0;
+	// size / nrBuckets
+	float loadFactor = 0.f;
+	// buckets looked at, all of them or the sampled ones
+	size_t nrVisitedBuckets = 0;
+	// chainLengthHistogram[i]: number of visited buckets holding i nodes, the last bin counts
+	// the longer chains as well
+	size_t chainLengthHistogram[c_rTableStatsNrHistogramBins] = {};
+	size_t maxChainLength = 0;
+	// average chain length of the visited buckets
+	float avgChainLength = 0.f;
+
+	// since the table initialization
+	uint64_t nrExpands = 0;
+	uint64_t expandNanos = 0;
+	uint64_t nrExpandGracePeriods = 0;
+	uint64_t nrShrinks = 0;
+	uint64_t shrinkNanos = 0;
+};
+
+// Read operation: must hold the read lock
+// Bucket occupancy and resize telemetry. nrSampledBuckets == 0 walks every bucket, otherwise
+// only about nrSampledBuckets evenly strided buckets are walked, cheap enough for production.
+RTableStats rTableCoreGetStats(const RTableCore& table, size_t nrSampledBuckets = 0);
+
 // Op is of function signature of bool(const RNode* p0), which returns if the entry is
 // what you are looking try erase but no synchronize This enables the caller to
 // do several rcuHashTableTryDetach operations, do one rcuHashTableSynchronize
 // and then do all the garbage collections.
+namespace rTableCoreDetail
+{
+	// rTableCoreTryDetachNoShrink by the hash stored in the nodes (already mixed, see
+	// RTableCore::mixHash), for the callers that take it from a node
+	template<typename UnaryPredicate>
+	RNode* tryDetachByBucketHash(RTableCore& table, size_t bucketHash, UnaryPredicate predict)
+	{
+		RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+		RTableCore::Bucket* pBucket = bucketOf(pBucketsInfo, bucketHash);
+		auto predictInner = [&predict](const RcuSlistHead* p)
+		{ return predict(YJ_CONTAINER_OF(p, RNode, head)); };
+		RcuSlistHead* pRemoved = rcuSlistRemoveIf(&pBucket->list, predictInner);
+		if (!pRemoved)
+			return nullptr;
+		table.size.fetch_sub(1, std::memory_order_relaxed);
+		bloomNoteRemoved(table, 1);
+		bumpGeneration(table);
+		return YJ_CONTAINER_OF(pRemoved, RNode, head);
+	}
+}	 // namespace rTableCoreDetail
+
 template<typename UnaryPredicate>
 RNode* rTableCoreTryDetachNoShrink(RTableCore& table, size_t hashVal, UnaryPredicate predict)
 {
-	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_acquire);
-	size_t bucketHash = pBucketsInfo->nrBucketsPowerOf2 - 1;
-	auto bucketId = hashVal & bucketHash;
-	RTableCore::Bucket* pBucket = pBucketsInfo->pBuckets + bucketId;
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreDetachNode");
+	return rTableCoreDetail::tryDetachByBucketHash(
+			table, rTableCoreDetail::bucketHash(table, hashVal), std::move(predict));
+}
+
+// Write operation: all writers must be serialized
+// Links pNewEntry in the position of the node matching predict (bool(const RNode*)) in one
+// chain traversal, readers see either the old or the new node but never a gap. The size does
+// not change. Returns the replaced node, which must only be freed after a synchronize, or
+// nullptr if nothing matched (and pNewEntry is not inserted).
+template<typename UnaryPredicate>
+RNode*
+rTableCoreReplace(RTableCore& table, size_t hashVal, UnaryPredicate predict, RNode* pNewEntry)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreDetachNode");
+	pNewEntry->hash = rTableCoreDetail::bucketHash(table, hashVal);
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, pNewEntry->hash);
 	auto predictInner = [&predict](const RcuSlistHead* p)
 	{ return predict(YJ_CONTAINER_OF(p, RNode, head)); };
-	RcuSlistHead* pRemoved = rcuSlistRemoveIf(&pBucket->list, predictInner);
-	if (!pRemoved)
+	RcuSlistHead* pReplaced = rcuSlistReplaceIf(&pBucket->list, predictInner, &pNewEntry->head);
+	if (!pReplaced)
 		return nullptr;
-	return YJ_CONTAINER_OF(pRemoved, RNode, head);
+	rTableCoreDetail::bumpGeneration(table);
+	return YJ_CONTAINER_OF(pReplaced, RNode, head);
 }
 
 // might shrink automatically
@@ -80,6 +347,29 @@ RNode* rTableCoreTryDetachAutoShrink(
 	}
 }
 
+namespace rTableCoreDetail
+{
+	// rTableCoreTryInsertNoExpand, also for the tables with handle nodes
+	template<typename BinaryPredict>
+	bool tryInsertNoExpand(
+			RTableCore& table,
+			RNode* pEntry,
+			size_t hashVal,
+			BinaryPredict binaryPredict)
+	{
+		pEntry->hash = bucketHash(table, hashVal);
+		bloomAdd(table, pEntry->hash);
+		RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+		RTableCore::Bucket* pBucket = bucketOf(pBucketsInfo, pEntry->hash);
+		auto binaryPredictInner = [&binaryPredict](const RcuSlistHead* p1, const RcuSlistHead* p2)
+		{ return binaryPredict(YJ_CONTAINER_OF(p1, RNode, head), YJ_CONTAINER_OF(p2, RNode, head)); };
+		bool inserted = rcuSlistPrependIfNoMatch(&pBucket->list, &pEntry->head, binaryPredictInner);
+		if (inserted)
+			table.size.fetch_add(1, std::memory_order_relaxed);
+		return inserted;
+	}
+}	 // namespace rTableCoreDetail
+
 template<typename BinaryPredict>
 bool rTableCoreTryInsertNoExpand(
 		RTableCore& table,
@@ -87,26 +377,151 @@ bool rTableCoreTryInsertNoExpand(
 		size_t hashVal,
 		BinaryPredict binaryPredict)
 {
-	pEntry->hash = hashVal;
-	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
-	size_t bucketMask = pBucketsInfo->nrBucketsPowerOf2 - 1;
-	auto bucketId = pEntry->hash & bucketMask;
-	RTableCore::Bucket* pBucket = pBucketsInfo->pBuckets + bucketId;
-	auto binaryPredictInner = [&binaryPredict](const RcuSlistHead* p1, const RcuSlistHead* p2)
-	{ return binaryPredict(YJ_CONTAINER_OF(p1, RNode, head), YJ_CONTAINER_OF(p2, RNode, head)); };
-	bool inserted = rcuSlistPrependIfNoMatch(&pBucket->list, &pEntry->head, binaryPredictInner);
-	if (inserted)
-		table.size.fetch_add(1, std::memory_order_relaxed);
-	return inserted;
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreHandleTryInsert");
+	return rTableCoreDetail::tryInsertNoExpand(table, pEntry, hashVal, binaryPredict);
 }
 
 // can only be called if the user is sure that no dup exists
+// pEntry->hash is used as it is: the hash stored in a node detached from this table, or for a
+// new node rTableCoreDetail::bucketHash(table, hashVal), which differs from hashVal with mixHash.
 void rTableCoreInsertNoExpand(RTableCore& table, RNode* pEntry);
 
 void rTableCoreExpandBuckets2x(RTableCore& table, RCUZone& zone);
 
 bool rTableCoreShrinkBuckets2x(RTableCore& table, RCUZone& zone);
 
+enum class RTableBulkDupPolicy
+{
+	// the caller guarantees that no node equals another node of the batch or of the table
+	NoDuplicates,
+	// nodes equal to a node of the table or to an earlier node of the batch are not inserted
+	SkipDuplicates,
+};
+
+// a bulk insert partition covers at most this many buckets, so that it links into a cache sized
+// range of the bucket array
+constexpr size_t c_rTableBulkPartitionBuckets = size_t(1) << 14;
+
+// Write operation: all writers must be serialized
+// Inserts n nodes, hashVals[i] is the hash of nodes[i]. RNode::hash is only written for the
+// nodes that get linked, the rejected ones are left as they were.
+// matchOp has the signature of the one of rTableCoreTryInsert, and is only used for
+// RTableBulkDupPolicy::SkipDuplicates.
+// The bucket array is sized once for the final element count: if the table is empty, a new
+// array is filled unpublished and published with one release store, otherwise the table is
+// expanded upfront and the nodes are prepended to their buckets.
+// The nodes are radix partitioned by bucket range and the partitions are linked by nrThreads
+// threads. No size update or expand check per node.
+// Returns the number of inserted nodes. nodes and hashVals are reordered alike, the inserted nodes
+// first and then the rejected duplicates.
+template<typename Op>
+size_t rTableCoreBulkInsert(
+		RTableCore& table,
+		RCUZone& zone,
+		RNode** nodes,
+		size_t* hashVals,
+		size_t n,
+		RTableBulkDupPolicy dupPolicy,
+		Op matchOp,
+		size_t nrThreads = 1)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreHandleTryInsert");
+	if (n == 0)
+		return 0;
+	std::vector<size_t> bucketHashes(n);
+	for (size_t i = 0; i < n; ++i)
+		bucketHashes[i] = rTableCoreDetail::bucketHash(table, hashVals[i]);
+	bool unpublished = false;
+	size_t nrElements = table.size.load(std::memory_order_relaxed) + n;
+	RTableCore::BucketsInfo* pInfo =
+			rTableCoreDetail::bulkReserveBuckets(table, zone, nrElements, unpublished);
+	size_t nrBuckets = pInfo->nrBucketsPowerOf2;
+	size_t bucketMask = nrBuckets - 1;
+
+	size_t nrPartitions = 1;
+	while (nrPartitions < nrBuckets &&
+				 (nrPartitions < nrThreads * 8 ||
+					nrBuckets / nrPartitions > c_rTableBulkPartitionBuckets))
+		nrPartitions *= 2;
+	size_t partitionShift = std::countr_zero(nrBuckets / nrPartitions);
+	auto partitionOf = [&](size_t i) { return (bucketHashes[i] & bucketMask) >> partitionShift; };
+
+	// counting sort of the node indices by partition
+	std::vector<size_t> partitionStarts(nrPartitions + 1, 0);
+	for (size_t i = 0; i < n; ++i)
+		++partitionStarts[partitionOf(i) + 1];
+	for (size_t iPartition = 0; iPartition < nrPartitions; ++iPartition)
+		partitionStarts[iPartition + 1] += partitionStarts[iPartition];
+	std::vector<size_t> order(n);
+	std::vector<size_t> partitionCursors(partitionStarts.begin(), partitionStarts.end() - 1);
+	for (size_t i = 0; i < n; ++i)
+		order[partitionCursors[partitionOf(i)]++] = i;
+
+	std::vector<char> rejected(n, 0);
+	std::atomic<size_t> nextPartition = 0;
+	std::atomic<size_t> nrInserted = 0;
+	auto binaryPredictInner = [&matchOp](const RcuSlistHead* p1, const RcuSlistHead* p2)
+	{ return matchOp(YJ_CONTAINER_OF(p1, RNode, head), YJ_CONTAINER_OF(p2, RNode, head)); };
+	auto worker = [&]()
+	{
+		size_t nrInsertedLocal = 0;
+		for (size_t iPartition = nextPartition.fetch_add(1, std::memory_order_relaxed);
+				 iPartition < nrPartitions;
+				 iPartition = nextPartition.fetch_add(1, std::memory_order_relaxed))
+			for (size_t k = partitionStarts[iPartition]; k < partitionStarts[iPartition + 1]; ++k)
+			{
+				RNode* pNode = nodes[order[k]];
+				size_t callerHash = pNode->hash;
+				pNode->hash = bucketHashes[order[k]];
+				RcuSlist* pList = &pInfo->pBuckets[pNode->hash & bucketMask].list;
+				rTableCoreDetail::bloomAdd(table, pNode->hash);
+				if (dupPolicy == RTableBulkDupPolicy::NoDuplicates)
+					rcuSlistInsertAfter(&pList->head, &pNode->head);
+				else if (!rcuSlistPrependIfNoMatch(pList, &pNode->head, binaryPredictInner))
+				{
+					// never linked, so no reader saw the bucket hash
+					pNode->hash = callerHash;
+					rejected[order[k]] = 1;
+					continue;
+				}
+				++nrInsertedLocal;
+			}
+		nrInserted.fetch_add(nrInsertedLocal, std::memory_order_relaxed);
+	};
+	size_t nrWorkers = std::min(nrThreads, nrPartitions);
+	std::vector<std::future<void>> futures(nrWorkers > 1 ? nrWorkers - 1 : 0);
+	for (auto& future : futures)
+		future = std::async(std::launch::async, worker);
+	worker();
+	for (auto& future : futures)
+		future.get();
+
+	if (unpublished)
+		rTableCoreDetail::bulkPublishBuckets(table, zone, pInfo);
+	size_t nrInsertedTotal = nrInserted.load(std::memory_order_relaxed);
+	table.size.fetch_add(nrInsertedTotal, std::memory_order_relaxed);
+	if (nrInsertedTotal != n)
+	{
+		std::vector<RNode*> rejectedNodes;
+		std::vector<size_t> rejectedHashVals;
+		size_t iOut = 0;
+		for (size_t i = 0; i < n; ++i)
+			if (rejected[i])
+			{
+				rejectedNodes.push_back(nodes[i]);
+				rejectedHashVals.push_back(hashVals[i]);
+			}
+			else
+			{
+				nodes[iOut] = nodes[i];
+				hashVals[iOut++] = hashVals[i];
+			}
+		std::copy(rejectedNodes.begin(), rejectedNodes.end(), nodes + iOut);
+		std::copy(rejectedHashVals.begin(), rejectedHashVals.end(), hashVals + iOut);
+	}
+	return nrInsertedTotal;
+}
+
 //-----------------------------------------------------------------------------------------------//
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -126,10 +541,11 @@ void rTableCoreInit(RTableCore& table);
 template<typename UnaryPrediction>
 RNode* rTableCoreFind(const RTableCore& table, size_t hashVal, UnaryPrediction predict)
 {
+	size_t bucketHash = rTableCoreDetail::bucketHash(table, hashVal);
+	if (!rTableCoreDetail::bloomMayContain(table, bucketHash))
+		return nullptr;
 	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_acquire);
-	size_t bucketHash = pBucketsInfo->nrBucketsPowerOf2 - 1;
-	auto bucketId = hashVal & bucketHash;
-	RTableCore::Bucket* pBucket = pBucketsInfo->pBuckets + bucketId;
+	RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, bucketHash);
 	auto predictInner = [&predict](const RcuSlistHead* p)
 	{ return predict(YJ_CONTAINER_OF(p, RNode, head)); };
 	RcuSlistHead* pFound = rcuSlistFindIf(&pBucket->list, predictInner);
@@ -138,6 +554,213 @@ RNode* rTableCoreFind(const RTableCore& table, size_t hashVal, UnaryPrediction p
 	return YJ_CONTAINER_OF(pFound, RNode, head);
 }
 
+// Read operation: must hold the read lock for as long as the returned node is used
+// rTableCoreFind through cache, a direct mapped cache of recent hits owned by the calling thread
+// (declare it thread_local). A hit costs one entry of the cache plus the predict call on the
+// node. Entries filled before the last detach, erase or replace of the table are ignored: the
+// generation is bumped before the grace period that precedes the reclamation of a node, so a
+// reader that still sees the old generation is inside that grace period and the node is alive.
+template<typename UnaryPrediction>
+RNode* rTableCoreCachedFind(
+		const RTableCore& table,
+		RTableHotCache& cache,
+		size_t hashVal,
+		UnaryPrediction predict)
+{
+	// by id and not by address: a table destroyed and rebuilt in place must not see the old entries
+	if (cache.tableId != table.id)
+	{
+		cache = RTableHotCache{};
+		cache.tableId = table.id;
+	}
+	uint64_t generation = table.generation.load(std::memory_order_acquire);
+	RTableHotCacheEntry& entry = cache.entries[rHashMix64(hashVal) & (c_rTableHotCacheNrEntries - 1)];
+	if (entry.generation == generation && entry.hash == hashVal && predict(entry.pNode))
+		return entry.pNode;
+	RNode* pFound = rTableCoreFind(table, hashVal, predict);
+	if (pFound)
+		entry = RTableHotCacheEntry{ generation, hashVal, pFound };
+	return pFound;
+}
+
+// Read operation
+// Multimap find: calls visitor (void(RNode*)) on every node matching predict (bool(const
+// RNode*)). The equal nodes are adjacent (see rTableCoreInsertMulti), so the walk stops at the
+// end of the first run of matches. Returns the number of visited nodes.
+template<typename UnaryPredicate, typename Visitor>
+size_t rTableCoreFindAll(
+		const RTableCore& table,
+		size_t hashVal,
+		UnaryPredicate predict,
+		Visitor visitor)
+{
+	size_t bucketHash = rTableCoreDetail::bucketHash(table, hashVal);
+	if (!rTableCoreDetail::bloomMayContain(table, bucketHash))
+		return 0;
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	const RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, bucketHash);
+	size_t nrVisited = 0;
+	for (RcuSlistHead* p = pBucket->list.head.next.load(std::memory_order_acquire); p != nullptr;
+			 p = p->next.load(std::memory_order_acquire))
+	{
+		RNode* pNode = YJ_CONTAINER_OF(p, RNode, head);
+		if (predict(pNode))
+		{
+			visitor(pNode);
+			++nrVisited;
+		}
+		else if (nrVisited > 0)
+			break;
+	}
+	return nrVisited;
+}
+
+// Read operation: the caller must hold a read lock for the whole call.
+// fn has function signature of void(RNode*). The bucket array is loaded once, and every node
+// linked during the whole call is visited exactly once, also while a resize is in progress.
+template<typename Fn>
+void rTableCoreForEach(const RTableCore& table, Fn fn)
+{
+	RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	rTableCoreDetail::forEachInBuckets(pInfo, 0, pInfo->nrBucketsPowerOf2, fn);
+}
+
+// number of buckets a worker of rTableCoreParallelForEach takes (or steals) at once
+constexpr size_t c_rTableForEachChunkSize = 1024;
+
+// Read operation: the caller must hold a read lock for the whole call. The read lock also
+// covers the worker threads, since no grace period can end before the call returns.
+// Same visiting guarantee as rTableCoreForEach. fn is called concurrently by nrThreads threads
+// (the calling thread is one of them). Every worker starts on its own range of bucket chunks
+// and steals the chunks of the others when it is done.
+template<typename Fn>
+void rTableCoreParallelForEach(const RTableCore& table, Fn fn, size_t nrThreads)
+{
+	RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	size_t nrBuckets = pInfo->nrBucketsPowerOf2;
+	size_t nrChunks = (nrBuckets + c_rTableForEachChunkSize - 1) / c_rTableForEachChunkSize;
+	if (nrThreads > nrChunks)
+		nrThreads = nrChunks;
+	if (nrThreads <= 1)
+	{
+		rTableCoreDetail::forEachInBuckets(pInfo, 0, nrBuckets, fn);
+		return;
+	}
+
+	std::vector<rTableCoreDetail::ForEachCursor> cursors(nrThreads);
+	for (size_t iThread = 0; iThread < nrThreads; ++iThread)
+	{
+		size_t beginChunk = nrChunks * iThread / nrThreads;
+		cursors[iThread].nextChunk.store(beginChunk, std::memory_order_relaxed);
+		cursors[iThread].endChunk = nrChunks * (iThread + 1) / nrThreads;
+	}
+	auto worker = [&](size_t iThread)
+	{
+		for (size_t iVictim = 0; iVictim < nrThreads; ++iVictim)
+		{
+			rTableCoreDetail::ForEachCursor& cursor = cursors[(iThread + iVictim) % nrThreads];
+			for (size_t iChunk = cursor.nextChunk.fetch_add(1, std::memory_order_relaxed);
+					 iChunk < cursor.endChunk;
+					 iChunk = cursor.nextChunk.fetch_add(1, std::memory_order_relaxed))
+			{
+				size_t iBegin = iChunk * c_rTableForEachChunkSize;
+				size_t iEnd = std::min(iBegin + c_rTableForEachChunkSize, nrBuckets);
+				rTableCoreDetail::forEachInBuckets(pInfo, iBegin, iEnd, fn);
+			}
+		}
+	};
+	std::vector<std::future<void>> futures(nrThreads - 1);
+	for (size_t iThread = 1; iThread < nrThreads; ++iThread)
+		futures[iThread - 1] = std::async(std::launch::async, worker, iThread);
+	worker(0);
+	for (auto& future : futures)
+		future.get();
+}
+
+// Read operation: the caller must hold a read lock for the call, but not in between calls.
+// Visits up to `budget` buckets starting at `cursor` (0 to start a scan) and returns the
+// cursor to continue with, 0 if the scan is complete. Every node linked from the start to the
+// end of the scan is visited at least once, even if the table is expanded or shrunk between
+// the calls. A node might be visited more than once if the table shrinks meanwhile.
+template<typename Fn>
+size_t rTableCoreScan(const RTableCore& table, size_t cursor, size_t budget, Fn fn)
+{
+	RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	size_t bucketMask = pInfo->nrBucketsPowerOf2 - 1;
+	do
+	{
+		size_t iBucket = cursor & bucketMask;
+		rTableCoreDetail::forEachInBuckets(pInfo, iBucket, iBucket + 1, fn);
+		cursor = rTableCoreDetail::nextScanCursor(cursor, bucketMask);
+	} while (cursor != 0 && budget-- > 1);
+	return cursor;
+}
+
+// number of lookups of rTableCoreFindBatch that are interleaved with each other
+constexpr size_t c_rTableFindBatchGroupSize = 16;
+
+// Read operation, batched rTableCoreFind
+// Looks up n keys: outNodes[i] receives the node matching (hashVals[i], keys[i]) or nullptr.
+// predict should have function signature of bool(const RNode*, const TKey&).
+// The whole batch must be inside one reader critical session. The bucket array is loaded once
+// and the lookups of a group are done in stages (prefetch the buckets, prefetch the first
+// nodes, then walk and compare), so the cache misses of different keys overlap.
+template<typename TKey, typename BinaryPredicate>
+void rTableCoreFindBatch(
+		const RTableCore& table,
+		const size_t* hashVals,
+		const TKey* keys,
+		RNode** outNodes,
+		size_t n,
+		BinaryPredicate predict)
+{
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	RTableCore::Bucket* pGroupBuckets[c_rTableFindBatchGroupSize];
+	RcuSlistHead* pGroupFirsts[c_rTableFindBatchGroupSize];
+	for (size_t groupStart = 0; groupStart < n; groupStart += c_rTableFindBatchGroupSize)
+	{
+		size_t groupSize = n - groupStart;
+		if (groupSize > c_rTableFindBatchGroupSize)
+			groupSize = c_rTableFindBatchGroupSize;
+		for (size_t i = 0; i < groupSize; ++i)
+		{
+			size_t bucketHash = rTableCoreDetail::bucketHash(table, hashVals[groupStart + i]);
+			// the filter rules out the misses before their buckets are fetched
+			pGroupBuckets[i] = nullptr;
+			if (!rTableCoreDetail::bloomMayContain(table, bucketHash))
+				continue;
+			pGroupBuckets[i] = rTableCoreDetail::bucketOf(pBucketsInfo, bucketHash);
+			YJ_PREFETCH(pGroupBuckets[i]);
+		}
+
+		for (size_t i = 0; i < groupSize; ++i)
+		{
+			pGroupFirsts[i] = nullptr;
+			if (pGroupBuckets[i])
+				pGroupFirsts[i] = pGroupBuckets[i]->list.head.next.load(std::memory_order_acquire);
+			if (pGroupFirsts[i])
+				YJ_PREFETCH(YJ_CONTAINER_OF(pGroupFirsts[i], RNode, head));
+		}
+
+		for (size_t i = 0; i < groupSize; ++i)
+		{
+			const TKey& key = keys[groupStart + i];
+			RNode* pFound = nullptr;
+			for (RcuSlistHead* p = pGroupFirsts[i]; p != nullptr;
+					 p = p->next.load(std::memory_order_acquire))
+			{
+				RNode* pNode = YJ_CONTAINER_OF(p, RNode, head);
+				if (predict(pNode, key))
+				{
+					pFound = pNode;
+					break;
+				}
+			}
+			outNodes[groupStart + i] = pFound;
+		}
+	}
+}
+
 // Write operation: all writers must be serialized
 // Op is of function signature of bool(RNode* p0, RcuHashTaleEntry* p1), which
 // returns if two hash table entries are equivalent. Expand if necessary
@@ -158,6 +781,109 @@ bool rTableCoreTryInsert(
 	return true;
 }
 
+// Write operation: all writers must be serialized
+// Returns the node matching predict (bool(const RNode*)), or inserts makeNode() (of signature
+// RNode*()) and returns it, in one chain traversal. makeNode is only called on a miss, so a hit
+// allocates nothing. outInserted tells which of the two happened. Expand if necessary.
+template<typename UnaryPredicate, typename Factory>
+RNode* rTableCoreFindOrInsert(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		size_t hashVal,
+		UnaryPredicate predict,
+		Factory makeNode,
+		bool* outInserted = nullptr)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreHandleTryInsert");
+	size_t bucketHash = rTableCoreDetail::bucketHash(table, hashVal);
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, bucketHash);
+	auto predictInner = [&predict](const RcuSlistHead* p)
+	{ return predict(YJ_CONTAINER_OF(p, RNode, head)); };
+	auto makeNew = [&table, &makeNode, bucketHash]()
+	{
+		RNode* pEntry = makeNode();
+		pEntry->hash = bucketHash;
+		rTableCoreDetail::bloomAdd(table, bucketHash);
+		return &pEntry->head;
+	};
+	bool inserted = false;
+	RcuSlistHead* p = rcuSlistFindOrPrepend(&pBucket->list, predictInner, makeNew, inserted);
+	if (outInserted)
+		*outInserted = inserted;
+	if (inserted)
+	{
+		auto currentSize = table.size.fetch_add(1, std::memory_order_relaxed) + 1;
+		rTableCoreDetail::expandBucketsByFac2IfNecessary(
+				currentSize, pBucketsInfo->nrBucketsPowerOf2, table, rcuZone);
+	}
+	return YJ_CONTAINER_OF(p, RNode, head);
+}
+
+// Write operation: all writers must be serialized
+// Multimap insert: duplicates are allowed, and pEntry is linked right behind the first node
+// matching predict (bool(const RNode*)), so that the equal nodes of a chain stay adjacent (expand
+// and shrink keep the order of the nodes of equal hash). Prepends if nothing matched.
+// Expand if necessary.
+template<typename UnaryPredicate>
+void rTableCoreInsertMulti(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		RNode* pEntry,
+		size_t hashVal,
+		UnaryPredicate predict)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreHandleTryInsert");
+	pEntry->hash = rTableCoreDetail::bucketHash(table, hashVal);
+	rTableCoreDetail::bloomAdd(table, pEntry->hash);
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, pEntry->hash);
+	RcuSlistHead* pPos = &pBucket->list.head;
+	for (RcuSlistHead* p = pPos->next.load(std::memory_order_relaxed); p != nullptr;
+			 p = p->next.load(std::memory_order_relaxed))
+		if (predict(YJ_CONTAINER_OF(p, RNode, head)))
+		{
+			pPos = p;
+			break;
+		}
+	rcuSlistInsertAfter(pPos, &pEntry->head);
+	auto currentSize = table.size.fetch_add(1, std::memory_order_relaxed) + 1;
+	rTableCoreDetail::expandBucketsByFac2IfNecessary(
+			currentSize, pBucketsInfo->nrBucketsPowerOf2, table, rcuZone);
+}
+
+// Write operation: all writers must be serialized
+// Replaces the node matching predict (bool(const RNode*)) by pEntry without a gap for the
+// readers (see rTableCoreReplace), or inserts pEntry if nothing matched, in one chain traversal.
+// Returns the replaced node, which must only be freed after a synchronize, or nullptr if pEntry
+// was inserted. Expand if necessary.
+template<typename UnaryPredicate>
+RNode* rTableCoreUpsert(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		RNode* pEntry,
+		size_t hashVal,
+		UnaryPredicate predict)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreHandleTryInsert");
+	pEntry->hash = rTableCoreDetail::bucketHash(table, hashVal);
+	rTableCoreDetail::bloomAdd(table, pEntry->hash);
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	RTableCore::Bucket* pBucket = rTableCoreDetail::bucketOf(pBucketsInfo, pEntry->hash);
+	auto predictInner = [&predict](const RcuSlistHead* p)
+	{ return predict(YJ_CONTAINER_OF(p, RNode, head)); };
+	RcuSlistHead* pReplaced = rcuSlistReplaceOrPrepend(&pBucket->list, predictInner, &pEntry->head);
+	if (pReplaced)
+	{
+		rTableCoreDetail::bumpGeneration(table);
+		return YJ_CONTAINER_OF(pReplaced, RNode, head);
+	}
+	auto currentSize = table.size.fetch_add(1, std::memory_order_relaxed) + 1;
+	rTableCoreDetail::expandBucketsByFac2IfNecessary(
+			currentSize, pBucketsInfo->nrBucketsPowerOf2, table, rcuZone);
+	return nullptr;
+}
+
 // Write operation: all writers must be serialized
 // Op is of function signature of bool(RNode* p0), which returns if the entry is
 // what you are looking for. rcuSynchronize is called internally and it is safe
@@ -175,4 +901,241 @@ rTableCoreTryDetachAndSynchronize(RTableCore& table, RCUZone& rcuZone, size_t ha
 		rcuSynchronize(rcuZone);
 	return pEntry;
 }
+
+// Write operation: all writers must be serialized
+// Unlinks every node that pred (bool(const RNode*)) matches in one pass over the buckets, then
+// shrinks if necessary, waits for one grace period and calls disposer (void(RNode*)) on each
+// unlinked node. Returns the number of erased nodes.
+template<typename UnaryPredicate, typename Disposer>
+size_t
+rTableCoreEraseIf(RTableCore& table, RCUZone& rcuZone, UnaryPredicate pred, Disposer disposer)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreDetachNode");
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	auto predictInner = [&pred](const RcuSlistHead* p)
+	{ return pred(YJ_CONTAINER_OF(p, RNode, head)); };
+	std::vector<RNode*> detached;
+	auto onRemoved = [&detached](RcuSlistHead* p)
+	{ detached.push_back(YJ_CONTAINER_OF(p, RNode, head)); };
+	for (size_t iBucket = 0; iBucket < pBucketsInfo->nrBucketsPowerOf2; ++iBucket)
+		rcuSlistRemoveAllIf(&pBucketsInfo->pBuckets[iBucket].list, predictInner, onRemoved);
+	if (detached.empty())
+		return 0;
+	table.size.fetch_sub(detached.size(), std::memory_order_relaxed);
+	rTableCoreDetail::bloomNoteRemoved(table, detached.size());
+	rTableCoreDetail::bumpGeneration(table);
+	if (!rTableCoreDetail::shrinkBucketsToFit(table, rcuZone))
+		rcuSynchronize(rcuZone);
+	for (RNode* pNode : detached)
+		disposer(pNode);
+	return detached.size();
+}
+
+// Write operation: all writers must be serialized
+// Batched rTableCoreTryDetachAndSynchronize: detaches the node matching (hashVals[i], keys[i])
+// for every i, with matchOp of signature bool(const RNode*, const TKey&). The keys are grouped by
+// bucket and each affected bucket is walked once. Shrinks once, waits for one grace period and
+// calls disposer (void(RNode*)) on each detached node.
+// Returns the number of detached nodes.
+template<typename TKey, typename BinaryPredicate, typename Disposer>
+size_t rTableCoreDetachMany(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		const size_t* hashVals,
+		const TKey* keys,
+		size_t n,
+		BinaryPredicate matchOp,
+		Disposer disposer)
+{
+	assert(!table.handleNodes && "does not keep the back pointers, see rTableCoreDetachNode");
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	size_t bucketMask = pBucketsInfo->nrBucketsPowerOf2 - 1;
+	std::vector<size_t> bucketHashes(n);
+	std::vector<size_t> order(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		bucketHashes[i] = rTableCoreDetail::bucketHash(table, hashVals[i]);
+		order[i] = i;
+	}
+	// stable, so that a key given twice detaches its nodes in the order of the chain
+	std::stable_sort(
+			order.begin(),
+			order.end(),
+			[&](size_t i0, size_t i1)
+			{ return (bucketHashes[i0] & bucketMask) < (bucketHashes[i1] & bucketMask); });
+
+	std::vector<RNode*> detached;
+	std::vector<bool> done(n, false);
+	for (size_t iBegin = 0, iEnd; iBegin < n; iBegin = iEnd)
+	{
+		size_t iBucket = bucketHashes[order[iBegin]] & bucketMask;
+		for (iEnd = iBegin + 1; iEnd < n && (bucketHashes[order[iEnd]] & bucketMask) == iBucket;)
+			++iEnd;
+		// a node is taken by the first of the bucket's keys that matches it and is not done yet,
+		// each key detaches one node as rTableCoreTryDetachNoShrink would
+		auto predictInner = [&](const RcuSlistHead* p)
+		{
+			const RNode* pNode = YJ_CONTAINER_OF(p, RNode, head);
+			for (size_t i = iBegin; i < iEnd; ++i)
+			{
+				size_t iKey = order[i];
+				if (!done[iKey] && pNode->hash == bucketHashes[iKey] && matchOp(pNode, keys[iKey]))
+				{
+					done[iKey] = true;
+					return true;
+				}
+			}
+			return false;
+		};
+		auto onRemoved = [&detached](RcuSlistHead* p)
+		{ detached.push_back(YJ_CONTAINER_OF(p, RNode, head)); };
+		rcuSlistRemoveAllIf(&pBucketsInfo->pBuckets[iBucket].list, predictInner, onRemoved);
+	}
+	if (detached.empty())
+		return 0;
+	table.size.fetch_sub(detached.size(), std::memory_order_relaxed);
+	rTableCoreDetail::bloomNoteRemoved(table, detached.size());
+	rTableCoreDetail::bumpGeneration(table);
+	if (!rTableCoreDetail::shrinkBucketsToFit(table, rcuZone))
+		rcuSynchronize(rcuZone);
+	for (RNode* pNode : detached)
+		disposer(pNode);
+	return detached.size();
+}
+
+// Write operation: all writers must be serialized
+// Unlinks all the nodes, waits for one grace period and calls disposer (void(RNode*)) on each of
+// them. The bucket array keeps its size. Returns the number of erased nodes.
+template<typename Disposer>
+size_t rTableCoreClear(RTableCore& table, RCUZone& rcuZone, Disposer disposer)
+{
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	std::vector<RNode*> detached;
+	for (size_t iBucket = 0; iBucket < pBucketsInfo->nrBucketsPowerOf2; ++iBucket)
+	{
+		RcuSlist* pList = &pBucketsInfo->pBuckets[iBucket].list;
+		// the chain stays intact for the readers on it, only the bucket is cut off
+		for (RcuSlistHead* p = pList->head.next.load(std::memory_order_relaxed); p != nullptr;
+				 p = p->next.load(std::memory_order_relaxed))
+			detached.push_back(YJ_CONTAINER_OF(p, RNode, head));
+		rcuSlistReset(pList);
+	}
+	if (detached.empty())
+		return 0;
+	table.size.fetch_sub(detached.size(), std::memory_order_relaxed);
+	rTableCoreDetail::bumpGeneration(table);
+	RTableBloom* pOldBloom = nullptr;
+	if (table.pBloom.load(std::memory_order_relaxed))
+		pOldBloom =
+				rTableCoreDetail::rebuildBloom(table, pBucketsInfo, pBucketsInfo->nrBucketsPowerOf2);
+	rcuSynchronize(rcuZone);
+	rTableCoreDetail::freeBloom(pOldBloom);
+	for (RNode* pNode : detached)
+		disposer(pNode);
+	return detached.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Handle nodes
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Only for tables initialized with RTableCoreConfig::handleNodes. The writers keep a back pointer
+// in each RHandleNode, so that a node held by the caller (from an expiry list for example) is
+// unlinked without walking its bucket. Besides the resizes and rTableLoad, only
+// rTableCoreHandleTryInsert, rTableCoreDetachNode and rTableCoreClear keep the back pointers, the
+// other write APIs assert that they are not used on such tables, neither the concurrent writer
+// mode. Readers are not affected.
+
+// Write operation: all writers must be serialized
+// Same semantics as rTableCoreTryInsert
+template<typename Op>
+bool rTableCoreHandleTryInsert(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		RHandleNode* pEntry,
+		size_t hashVal,
+		Op matchOp)
+{
+	if (!rTableCoreDetail::tryInsertNoExpand(table, &pEntry->node, hashVal, matchOp))
+		return false;
+	// prepended to the bucket
+	RTableCore::BucketsInfo* pBucketsInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	pEntry->pPrev = &rTableCoreDetail::bucketOf(pBucketsInfo, pEntry->node.hash)->list.head;
+	RcuSlistHead* pNext = pEntry->node.head.next.load(std::memory_order_relaxed);
+	if (pNext)
+		rTableCoreDetail::handleOf(pNext)->pPrev = &pEntry->node.head;
+	rTableCoreDetail::expandBucketsByFac2IfNecessary(
+			table.size.load(std::memory_order_relaxed),
+			pBucketsInfo->nrBucketsPowerOf2,
+			table,
+			rcuZone);
+	return true;
+}
+
+// Write operation: all writers must be serialized
+// Unlinks pNode in O(1), without synchronization and without shrinking, like
+// rTableCoreTryDetachNoShrink. Readers on pNode continue to its successor, free it after a grace
+// period.
+void rTableCoreDetachNode(RTableCore& table, RHandleNode* pNode);
+
+// Write operation: all writers must be serialized
+// rTableCoreDetachNode, then shrinks if necessary and waits for a grace period. pNode can be
+// freed on return.
+void rTableCoreDetachNodeAndSynchronize(RTableCore& table, RCUZone& rcuZone, RHandleNode* pNode);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Concurrent writer mode
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Only for tables initialized with RTableCoreConfig::nrWriterStripes > 0.
+// These writers do not need to be serialized with each other: a writer only takes the spinlock
+// of the stripe of its bucket, and a resize takes all of them. Every other write API must still
+// be serialized with them by the caller. Readers are not affected.
+
+// Write operation: concurrent with other concurrent writers
+// Same semantics as rTableCoreTryInsert
+template<typename Op>
+bool rTableCoreConcurrentTryInsert(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		RNode* pEntry,
+		size_t hashVal,
+		Op matchOp)
+{
+	size_t currentSize;
+	size_t nrBuckets;
+	{
+		rTableCoreDetail::WriterStripeGuard l{ table, hashVal };
+		if (!rTableCoreTryInsertNoExpand(table, pEntry, hashVal, matchOp))
+			return false;
+		// the buckets info can only be read when holding a stripe since a resize might free it
+		currentSize = table.size.load(std::memory_order_relaxed);
+		nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+	}
+	rTableCoreDetail::concurrentExpandIfNecessary(currentSize, nrBuckets, table, rcuZone);
+	return true;
+}
+
+// Write operation: concurrent with other concurrent writers
+// Same semantics as rTableCoreTryDetachAndSynchronize
+template<typename Op>
+RNode* rTableCoreConcurrentTryDetachAndSynchronize(
+		RTableCore& table,
+		RCUZone& rcuZone,
+		size_t hashVal,
+		Op matchOp)
+{
+	RNode* pEntry;
+	size_t currentSize;
+	size_t nrBuckets;
+	{
+		rTableCoreDetail::WriterStripeGuard l{ table, hashVal };
+		pEntry = rTableCoreTryDetachNoShrink(table, hashVal, matchOp);
+		if (pEntry == nullptr)
+			return pEntry;
+		currentSize = table.size.load(std::memory_order_relaxed);
+		nrBuckets = table.pBucketsInfo.load(std::memory_order_relaxed)->nrBucketsPowerOf2;
+	}
+	if (!rTableCoreDetail::concurrentShrinkIfNecessary(currentSize, nrBuckets, table, rcuZone))
+		rcuSynchronize(rcuZone);
+	return pEntry;
+}
 }	 // namespace yrcu
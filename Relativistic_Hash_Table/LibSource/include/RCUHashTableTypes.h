@@ -9,6 +9,42 @@ struct RNode
 	RcuSlistHead head;
 };
 
+// Node of the tables configured with handleNodes, see rTableCoreDetachNode.
+// pPrev is the link pointing to this node, the bucket head or the head of the predecessor. It is
+// only used by the writers.
+struct RHandleNode
+{
+	RNode node;
+	RcuSlistHead* pPrev = nullptr;
+};
+
+// Spinlock of the opt-in concurrent writer mode. A stripe guards all the buckets whose id
+// equals to the stripe id modulo the number of stripes.
+struct alignas(64) RTableWriterStripe
+{
+	std::atomic<bool> locked = false;
+};
+
+// One cache line of a blocked Bloom filter, a key sets one bit in each of the 8 words
+struct alignas(64) RTableBloomBlock
+{
+	std::atomic<uint64_t> words[8];
+};
+
+// Filter over the hashes of the nodes of a table, see RTableCore::pBloom
+struct RTableBloom
+{
+	size_t nrBlocksPowerOf2;
+	RTableBloomBlock* pBlocks;
+	// number of nodes the filter is sized for
+	size_t capacity;
+	// nodes removed since the filter was built, their bits are still set
+	std::atomic<size_t> nrRemoved = 0;
+};
+
+// default RTableCore::bucketsMmapThresholdBytes, the size of one transparent huge page
+constexpr size_t c_rTableBucketsMmapThresholdBytes = size_t(2) << 20;
+
 // RTableCore does not include the RCUZone and thus is feasible for shared RCUZone
 struct RTableCore
 {
@@ -24,6 +60,10 @@ struct RTableCore
 	{
 		size_t nrBucketsPowerOf2;
 		Bucket* pBuckets;
+		// bytes of the allocation holding this info and the buckets
+		size_t allocSize;
+		// mapped from the os instead of malloc-ed
+		bool mmapped;
 	};
 
 	// expand when element/buckets-count grows over this factor
@@ -32,6 +72,73 @@ struct RTableCore
 	float shrinkFactor = 8.f;
 
 	std::atomic<BucketsInfo*> pBucketsInfo = nullptr;
+
+	// Bucket arrays of at least this many bytes are mapped from the os (linux only), zero filled
+	// lazily by the kernel and backed by transparent huge pages. On by default, 0 disables it.
+	size_t bucketsMmapThresholdBytes = c_rTableBucketsMmapThresholdBytes;
+	// try the hugetlbfs pool (MAP_HUGETLB) first for mapped bucket arrays
+	bool bucketsUseHugeTlb = false;
+	// interleave the pages of mapped bucket arrays over the allowed NUMA nodes
+	bool bucketsInterleaveNuma = false;
+
+	// Mix every hash passed to the table with rHashMix64 before selecting the bucket, for weak
+	// hash functions like the identity std::hash of integers. RNode::hash holds the mixed hash,
+	// so a snapshot must be loaded into a table with the same setting.
+	bool mixHash = false;
+
+	// All the nodes are RHandleNode and the writers keep their back pointers, so that a node
+	// is unlinked in O(1) by rTableCoreDetachNode. The back pointers are recomputed after each
+	// resize.
+	bool handleNodes = false;
+
+	// Optional filter consulted by the finds before they touch the bucket, so that a miss costs
+	// one cache line. Writers set the bits of every inserted node. Bits of removed nodes stay
+	// set, the filter is rebuilt and republished with each resize and once the removed nodes
+	// overflow its capacity. nullptr unless bloomBitsPerElement > 0.
+	int bloomBitsPerElement = 0;
+	std::atomic<RTableBloom*> pBloom = nullptr;
+
+	// Bumped by the writers whenever a node leaves the table (detach, erase, replace), before
+	// the grace period that precedes its reclamation. Validates the entries of RTableHotCache.
+	std::atomic<uint64_t> generation = 1;
+	// unique among all the tables of the process (never reused, unlike the address), 0 until init
+	uint64_t id = 0;
+
+	// Resize telemetry, see rTableCoreGetStats. Only written by the resizing writer.
+	std::atomic<uint64_t> nrExpands = 0;
+	std::atomic<uint64_t> expandNanos = 0;
+	// grace periods waited by the expands, one for publishing plus one per unzip round
+	std::atomic<uint64_t> nrExpandGracePeriods = 0;
+	std::atomic<uint64_t> nrShrinks = 0;
+	std::atomic<uint64_t> shrinkNanos = 0;
+
+	// Concurrent writer mode, only set up if configured with writer stripes.
+	// The bucket count never goes below the stripe count, so that the nodes of one bucket
+	// (and the two buckets an expand or shrink touches) always belong to the same stripe.
+	size_t nrWriterStripesPowerOf2 = 0;
+	RTableWriterStripe* pWriterStripes = nullptr;
+	// taken by the writer who resizes, before it takes all the stripes
+	std::atomic<bool> writerResizing = false;
+};
+
+constexpr size_t c_rTableHotCacheNrEntries = 256;
+
+struct RTableHotCacheEntry
+{
+	uint64_t generation = 0;
+	size_t hash = 0;
+	RNode* pNode = nullptr;
+};
+
+// Direct mapped cache of the nodes found recently in one table, for thread_local use.
+// An entry is only returned while the cache is bound to the same table (by RTableCore::id) and
+// the generation of the table has not changed since the entry was filled, so a hit is never a
+// node already past its grace period, see rTableCoreCachedFind.
+struct RTableHotCache
+{
+	// 0 is no table, so the zero initialized entries never hit
+	uint64_t tableId = 0;
+	RTableHotCacheEntry entries[c_rTableHotCacheNrEntries];
 };
 
 struct RTable
@@ -1,5 +1,6 @@
 #pragma once
 #include <atomic>
+#include <mutex>
 
 namespace yrcu
 {
@@ -30,7 +31,10 @@ struct RCUZone
 	int nrHashThreadBuckets = 0;
 	EpochBuckets epochsRing[c_maxEpoches];
 	std::atomic<int64_t> epochLatest = 0;
-	int64_t epochOldest = 0;
+	// atomic since rcuIfEpochDrained reads it outside of synchronizeMutex
+	std::atomic<int64_t> epochOldest = 0;
+	// serializes concurrent rcuSynchronize calls, which share epochOldest
+	std::mutex synchronizeMutex;
 
 	~RCUZone();
 };
@@ -0,0 +1,166 @@
+#pragma once
+#include <vector>
+
+#include "RCUApi.h"
+#include "RCUHashTableCoreApi.h"
+#include "RCacheTypes.h"
+
+namespace yrcu
+{
+namespace rCacheDetail
+{
+	// links a newly inserted node into the ring right behind the hand, so that it is swept last
+	void ringLink(RCache& cache, RCacheNode* pNode);
+	// sweeps the ring and detaches up to nrEntries cold nodes from the table and the ring,
+	// without synchronization. pKeep, if not null, is passed over and never detached.
+	void detachCold(
+			RCache& cache,
+			size_t nrEntries,
+			std::vector<RCacheNode*>& outDetached,
+			const RCacheNode* pKeep = nullptr);
+	// detaches pNode from the ring
+	void ringUnlink(RCache& cache, RCacheNode* pNode);
+}	 // namespace rCacheDetail
+
+//////////////////////////////////////////////////////////////
+//--------------------------Advanced API--------------------//
+//////////////////////////////////////////////////////////////
+struct RCacheConfig
+{
+	size_t capacity = 1024;
+	// entries evicted at once when the capacity is exceeded, they share one grace period.
+	// Clamped to capacity.
+	size_t nrEvictBatch = 64;
+	int nrRcuBucketsForUnregisteredThreads = 128;
+};
+
+void rCacheInitDetailed(RCache& cache, const RCacheConfig& conf);
+
+// Write operation: all writers must be serialized
+// Sweeps the ring and evicts up to nrEntries cold entries with one grace period, then calls
+// disposer (void(RCacheNode*)) on each of them. Returns the number of evicted entries.
+// pKeep, if not null, is not evicted even if it is cold.
+template<typename Disposer>
+size_t rCacheEvict(
+		RCache& cache,
+		size_t nrEntries,
+		Disposer disposer,
+		const RCacheNode* pKeep = nullptr)
+{
+	std::vector<RCacheNode*> detached;
+	rCacheDetail::detachCold(cache, nrEntries, detached, pKeep);
+	if (detached.empty())
+		return 0;
+	if (!rTableCoreDetail::shrinkBucketsToFit(cache.core, cache.rcuZone))
+		rcuSynchronize(cache.rcuZone);
+	for (RCacheNode* pNode : detached)
+		disposer(pNode);
+	return detached.size();
+}
+
+//---------------------------------------------------------------------------//
+
+////////////////////////////////////////////////////////////////
+//--------------------------------Basic API-------------------//
+////////////////////////////////////////////////////////////////
+void rCacheInit(RCache& cache, size_t capacity = 1024);
+
+// same semantics as rTableReadLock/rTableReadUnlock
+int64_t rCacheReadLock(RCache& cache);
+void rCacheReadUnlock(RCache& cache, int64_t epoch);
+struct RCacheReadLockGuard
+{
+	explicit RCacheReadLockGuard(RCache& cache) : c{ cache }
+	{
+		epoch = rCacheReadLock(cache);
+	}
+	RCacheReadLockGuard(const RCacheReadLockGuard&) = delete;
+	RCacheReadLockGuard(RCacheReadLockGuard&&) = delete;
+	RCacheReadLockGuard& operator=(const RCacheReadLockGuard&) = delete;
+	RCacheReadLockGuard& operator=(RCacheReadLockGuard&&) = delete;
+
+	~RCacheReadLockGuard()
+	{
+		rCacheReadUnlock(c, epoch);
+	}
+	RCache& c;
+	int64_t epoch = 0;
+};
+
+// Read operation, same semantics as rTableFind.
+// A hit marks the entry as referenced with a relaxed store, no lock and no list update. The
+// store is skipped if the flag is already set, so hot entries stay shared in the caches.
+template<typename Op>
+RCacheNode* rCacheFind(const RCache& cache, size_t hashVal, Op matchOp)
+{
+	RNode* pEntry = rTableCoreFind(
+			cache.core,
+			hashVal,
+			[&matchOp](const RNode* p) { return matchOp(YJ_CONTAINER_OF(p, RCacheNode, entry)); });
+	if (pEntry == nullptr)
+		return nullptr;
+	RCacheNode* pNode = YJ_CONTAINER_OF(pEntry, RCacheNode, entry);
+	if (!pNode->referenced.load(std::memory_order_relaxed))
+		pNode->referenced.store(true, std::memory_order_relaxed);
+	return pNode;
+}
+
+// Write operation: all writers must be serialized
+// matchOp has function signature of bool(const RCacheNode*, const RCacheNode*).
+// Returns false if an equal entry exists. If the capacity is exceeded, nrEvictBatch cold entries
+// are evicted with one grace period and passed to disposer (void(RCacheNode*)), never pNode.
+template<typename Op, typename Disposer>
+bool rCacheTryInsert(
+		RCache& cache,
+		RCacheNode* pNode,
+		size_t hashVal,
+		Op matchOp,
+		Disposer disposer)
+{
+	pNode->referenced.store(false, std::memory_order_relaxed);
+	bool inserted = rTableCoreTryInsert(
+			cache.core,
+			cache.rcuZone,
+			&pNode->entry,
+			hashVal,
+			[&matchOp](const RNode* p1, const RNode* p2)
+			{
+				return matchOp(
+						YJ_CONTAINER_OF(p1, RCacheNode, entry), YJ_CONTAINER_OF(p2, RCacheNode, entry));
+			});
+	if (!inserted)
+		return false;
+	rCacheDetail::ringLink(cache, pNode);
+	if (cache.core.size.load(std::memory_order_relaxed) > cache.capacity)
+		rCacheEvict(cache, cache.nrEvictBatch, disposer, pNode);
+	return true;
+}
+
+// Write operation: all writers must be serialized
+// matchOp has function signature of bool(const RCacheNode*). Returns the erased node, which is
+// safe to free since rcuSynchronize is called internally, or nullptr.
+template<typename Op>
+RCacheNode* rCacheTryDetachAndSynchronize(RCache& cache, size_t hashVal, Op matchOp)
+{
+	RNode* pEntry = rTableCoreTryDetachAndSynchronize(
+			cache.core,
+			cache.rcuZone,
+			hashVal,
+			[&matchOp](const RNode* p) { return matchOp(YJ_CONTAINER_OF(p, RCacheNode, entry)); });
+	if (pEntry == nullptr)
+		return nullptr;
+	RCacheNode* pNode = YJ_CONTAINER_OF(pEntry, RCacheNode, entry);
+	rCacheDetail::ringUnlink(cache, pNode);
+	return pNode;
+}
+
+// Write operation: all writers must be serialized
+// Evicts all the entries with one grace period, see rCacheEvict.
+template<typename Disposer>
+size_t rCacheClear(RCache& cache, Disposer disposer)
+{
+	return rCacheEvict(cache, cache.core.size.load(std::memory_order_relaxed), disposer);
+}
+
+size_t rCacheSize(const RCache& cache);
+}	 // namespace yrcu
@@ -0,0 +1,31 @@
+#pragma once
+#include <atomic>
+
+#include "RCUHashTableTypes.h"
+#include "RCUTypes.h"
+#include "RcuDoublyLinkedListTypes.h"
+namespace yrcu
+{
+// Entry of a RCache: the RNode links it into the table, the ring head into the clock ring.
+// Readers only set `referenced`, the ring is touched by the writer only.
+struct RCacheNode
+{
+	RNode entry;
+	RcuDlistHead ringHead;
+	std::atomic<bool> referenced = false;
+};
+
+// RTableCore for the lookups plus a CLOCK ring of all the entries for the recency. The hand
+// sweeps the ring: a referenced entry gets a second chance, a cold one is evicted.
+// The cache does not own its nodes, the disposers passed to the write APIs free them.
+struct RCache
+{
+	RTableCore core;
+	RCUZone rcuZone;
+	RcuDlist ring;
+	// next entry the sweep looks at, &ring.head if the ring is empty
+	RcuDlistHead* pHand = nullptr;
+	size_t capacity = 0;
+	size_t nrEvictBatch = 0;
+};
+}	 // namespace yrcu
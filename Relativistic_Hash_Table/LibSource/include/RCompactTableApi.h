@@ -0,0 +1,162 @@
+#pragma once
+#include "RCUApi.h"
+#include "RCompactTableTypes.h"
+
+namespace yrcu
+{
+namespace rCompactTableDetail
+{
+	inline RCompactNode* nodeAt(const RCompactTable& table, uint32_t index)
+	{
+		return (RCompactNode*)(table.pArenaBase + index * table.nodeStride + table.nodeOffset);
+	}
+
+	inline std::atomic<uint32_t>* bucketOf(const RCompactTable::BucketsInfo* pInfo, uint32_t hash)
+	{
+		return pInfo->pBuckets + (hash & (pInfo->nrBucketsPowerOf2 - 1));
+	}
+
+	void expandIfNecessary(RCompactTable& table);
+	// returns if synchronized
+	bool shrinkIfNecessary(RCompactTable& table);
+}	 // namespace rCompactTableDetail
+
+//////////////////////////////////////////////////////////////
+//--------------------------Advanced API--------------------//
+//////////////////////////////////////////////////////////////
+struct RCompactTableConfig
+{
+	int nrBuckets = 64;
+	float expandFactor = 1.1f;
+	float shrinkFactor = 0.25f;
+	int nrRcuBucketsForUnregisteredThreads = 128;
+};
+
+// pArenaBase: the first element of the arena, nodeStride: the element size,
+// nodeOffset: the offset of the RCompactNode in the element, e.g.
+// rCompactTableInitDetailed(table, elements, sizeof(Element), offsetof(Element, node), conf)
+void rCompactTableInitDetailed(
+		RCompactTable& table,
+		void* pArenaBase,
+		size_t nodeStride,
+		size_t nodeOffset,
+		const RCompactTableConfig& conf);
+
+// Write operation: all writers must be serialized
+void rCompactTableExpandBuckets2x(RCompactTable& table);
+bool rCompactTableShrinkBuckets2x(RCompactTable& table);
+
+//---------------------------------------------------------------------------//
+
+////////////////////////////////////////////////////////////////
+//--------------------------------Basic API-------------------//
+////////////////////////////////////////////////////////////////
+void rCompactTableInit(
+		RCompactTable& table,
+		void* pArenaBase,
+		size_t nodeStride,
+		size_t nodeOffset,
+		int nrBuckets = 64);
+
+// same semantics as rTableReadLock/rTableReadUnlock
+int64_t rCompactTableReadLock(RCompactTable& table);
+void rCompactTableReadUnlock(RCompactTable& table, int64_t epoch);
+struct RCompactTableReadLockGuard
+{
+	explicit RCompactTableReadLockGuard(RCompactTable& table) : tbl{ table }
+	{
+		epoch = rCompactTableReadLock(table);
+	}
+	RCompactTableReadLockGuard(const RCompactTableReadLockGuard&) = delete;
+	RCompactTableReadLockGuard(RCompactTableReadLockGuard&&) = delete;
+	RCompactTableReadLockGuard& operator=(const RCompactTableReadLockGuard&) = delete;
+	RCompactTableReadLockGuard& operator=(RCompactTableReadLockGuard&&) = delete;
+
+	~RCompactTableReadLockGuard()
+	{
+		rCompactTableReadUnlock(tbl, epoch);
+	}
+	RCompactTable& tbl;
+	int64_t epoch = 0;
+};
+
+// Read operation
+// Returns the arena index of the node with the hash that matchOp (bool(uint32_t index))
+// accepts, or c_rCompactNull. matchOp is only called for the nodes with equal 32-bit hashes.
+template<typename UnaryPredicate>
+uint32_t rCompactTableFind(const RCompactTable& table, size_t hashVal, UnaryPredicate matchOp)
+{
+	uint32_t hash = (uint32_t)hashVal;
+	RCompactTable::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	for (uint32_t index = rCompactTableDetail::bucketOf(pInfo, hash)->load(std::memory_order_acquire);
+			 index != c_rCompactNull;)
+	{
+		const RCompactNode* pNode = rCompactTableDetail::nodeAt(table, index);
+		if (pNode->hash == hash && matchOp(index))
+			return index;
+		index = pNode->next.load(std::memory_order_acquire);
+	}
+	return c_rCompactNull;
+}
+
+// Write operation: all writers must be serialized
+// Links the element of the arena index unless a node with the hash that matchOp
+// (bool(uint32_t existingIndex)) accepts exists. Expands if necessary.
+template<typename UnaryPredicate>
+bool rCompactTableTryInsert(
+		RCompactTable& table,
+		uint32_t index,
+		size_t hashVal,
+		UnaryPredicate matchOp)
+{
+	uint32_t hash = (uint32_t)hashVal;
+	RCompactTable::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	std::atomic<uint32_t>* pBucket = rCompactTableDetail::bucketOf(pInfo, hash);
+	uint32_t first = pBucket->load(std::memory_order_relaxed);
+	for (uint32_t i = first; i != c_rCompactNull;)
+	{
+		const RCompactNode* pNode = rCompactTableDetail::nodeAt(table, i);
+		if (pNode->hash == hash && matchOp(i))
+			return false;
+		i = pNode->next.load(std::memory_order_relaxed);
+	}
+	RCompactNode* pNew = rCompactTableDetail::nodeAt(table, index);
+	pNew->hash = hash;
+	pNew->next.store(first, std::memory_order_relaxed);
+	pBucket->store(index, std::memory_order_release);
+	table.size.fetch_add(1, std::memory_order_relaxed);
+	rCompactTableDetail::expandIfNecessary(table);
+	return true;
+}
+
+// Write operation: all writers must be serialized
+// Unlinks the node that matchOp (bool(uint32_t index)) accepts, shrinks if necessary and waits
+// for a grace period. Returns its arena index, which can be reused right away, or
+// c_rCompactNull.
+template<typename UnaryPredicate>
+uint32_t
+rCompactTableTryDetachAndSynchronize(RCompactTable& table, size_t hashVal, UnaryPredicate matchOp)
+{
+	uint32_t hash = (uint32_t)hashVal;
+	RCompactTable::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_relaxed);
+	std::atomic<uint32_t>* pPrevNext = rCompactTableDetail::bucketOf(pInfo, hash);
+	for (uint32_t index = pPrevNext->load(std::memory_order_relaxed); index != c_rCompactNull;)
+	{
+		RCompactNode* pNode = rCompactTableDetail::nodeAt(table, index);
+		if (pNode->hash == hash && matchOp(index))
+		{
+			// readers on the node continue to its successor
+			pPrevNext->store(pNode->next.load(std::memory_order_relaxed), std::memory_order_release);
+			table.size.fetch_sub(1, std::memory_order_relaxed);
+			if (!rCompactTableDetail::shrinkIfNecessary(table))
+				rcuSynchronize(table.rcuZone);
+			return index;
+		}
+		pPrevNext = &pNode->next;
+		index = pPrevNext->load(std::memory_order_relaxed);
+	}
+	return c_rCompactNull;
+}
+
+size_t rCompactTableSize(const RCompactTable& table);
+}	 // namespace yrcu
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "RCUTypes.h"
+namespace yrcu
+{
+// index of no node, ends a chain
+constexpr uint32_t c_rCompactNull = 0xFFFFFFFFu;
+
+// Link of a RCompactTable, embedded in the arena elements just like RNode. 8 bytes instead of
+// the 16 of RNode: the low 32 bits of the hash and the arena index of the next node.
+struct RCompactNode
+{
+	uint32_t hash;
+	std::atomic<uint32_t> next;
+};
+
+// Relativistic hash table over the elements of one arena, linked by 32-bit arena indices
+// instead of pointers. A bucket is a 4 byte chain head, so twice as many buckets fit in a cache
+// line as in RTableCore. Same resize scheme as RTableCore: unzip on expand, splice on shrink.
+// Holds at most c_rCompactNull - 1 nodes and 2^32 buckets.
+struct RCompactTable
+{
+	~RCompactTable();
+
+	// the RCompactNode of index i is at pArenaBase + i * nodeStride + nodeOffset
+	char* pArenaBase = nullptr;
+	size_t nodeStride = 0;
+	size_t nodeOffset = 0;
+
+	std::atomic<size_t> size = 0;
+
+	struct BucketsInfo
+	{
+		size_t nrBucketsPowerOf2;
+		// arena index of the first node of each bucket
+		std::atomic<uint32_t>* pBuckets;
+	};
+	std::atomic<BucketsInfo*> pBucketsInfo = nullptr;
+
+	float expandFactor = 1.1f;
+	float shrinkFactor = 0.25f;
+	RCUZone rcuZone;
+};
+}	 // namespace yrcu
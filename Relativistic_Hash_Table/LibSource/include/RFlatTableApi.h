@@ -0,0 +1,192 @@
+#pragma once
+#include <bit>
+
+#include "RCUApi.h"
+#include "RFlatTableTypes.h"
+#include "RHashers.h"
+#include "RcuSinglyLinkedListApi.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YJ_FLAT_TABLE_SSE2
+#endif
+
+namespace yrcu
+{
+namespace rFlatTableDetail
+{
+	// the table hashes the keys itself since rehashing needs the hash of every stored key.
+	// Multiply-xorshift mix, so that sequential or strided integer keys spread over the groups
+	// and the control bytes.
+	inline uint64_t mixHash(uint64_t key)
+	{
+		return rHashMix64(key);
+	}
+
+	inline uint8_t ctrlOfHash(uint64_t mixedHash)
+	{
+		return (uint8_t)(mixedHash & 0x7F);
+	}
+
+	inline size_t firstGroupOfHash(uint64_t mixedHash, size_t groupMask)
+	{
+		return (size_t)(mixedHash >> 7) & groupMask;
+	}
+
+	struct GroupCtrls
+	{
+		uint64_t w0;
+		uint64_t w1;
+	};
+
+	inline GroupCtrls loadGroup(const std::atomic<uint64_t>* pGroupCtrlWords)
+	{
+		return GroupCtrls{ pGroupCtrlWords[0].load(std::memory_order_acquire),
+											 pGroupCtrlWords[1].load(std::memory_order_acquire) };
+	}
+
+	// returns a bit mask, bit i is set if control byte i of the group equals to ctrl
+	inline uint32_t matchGroup(const GroupCtrls& group, uint8_t ctrl)
+	{
+		uint64_t w0 = group.w0;
+		uint64_t w1 = group.w1;
+#ifdef YJ_FLAT_TABLE_SSE2
+		__m128i ctrls = _mm_set_epi64x((long long)w1, (long long)w0);
+		__m128i target = _mm_set1_epi8((char)ctrl);
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrls, target));
+#else
+		// swar: exact per byte equality, then gather the high bit of each byte
+		constexpr uint64_t c_lows = 0x0101010101010101ull;
+		constexpr uint64_t c_low7s = 0x7F7F7F7F7F7F7F7Full;
+		constexpr uint64_t c_highs = 0x8080808080808080ull;
+		auto matchWord = [&](uint64_t w) -> uint32_t
+		{
+			uint64_t x = w ^ (c_lows * ctrl);
+			uint64_t zeroBytes = ~(((x & c_low7s) + c_low7s) | x) & c_highs;
+			return (uint32_t)(((zeroBytes >> 7) * 0x0002040810204081ull) >> 56);
+		};
+		return matchWord(w0) | (matchWord(w1) << 8);
+#endif
+	}
+
+	inline uint8_t loadCtrl(const RFlatTableCore::SlotsInfo* pInfo, size_t slotId)
+	{
+		uint64_t w = pInfo->pCtrlWords[slotId / sizeof(uint64_t)].load(std::memory_order_relaxed);
+		return (uint8_t)(w >> (8 * (slotId % sizeof(uint64_t))));
+	}
+}	 // namespace rFlatTableDetail
+
+//////////////////////////////////////////////
+//         Advanced API
+/////////////////////////////////////////////
+
+struct RFlatTableCoreConfig
+{
+	size_t nrSlots = 64;
+	float maxLoadFactor = 0.875f;
+};
+
+void rFlatTableCoreInitDetailed(RFlatTableCore& table, const RFlatTableCoreConfig& conf);
+
+// Write operation: all writers must be serialized
+// Erase but no synchronize, the slot is not reused before the next rFlatTableCoreSynchronize.
+// This enables the caller to do several detaches, one synchronize and then free all the values.
+// Returns the value of the erased key or nullptr.
+void* rFlatTableCoreTryDetachNoSynchronize(RFlatTableCore& table, uint64_t key);
+
+// Write operation: all writers must be serialized
+// wait for the readers and make the slots of the previous detaches reusable
+void rFlatTableCoreSynchronize(RFlatTableCore& table, RCUZone& zone);
+
+// Write operation: all writers must be serialized
+// rehash into (at least) nrSlots slots, tombstones are dropped
+void rFlatTableCoreRehash(RFlatTableCore& table, RCUZone& zone, size_t nrSlots);
+
+//-----------------------------------------------------------------------------------------------//
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Basic API
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void rFlatTableCoreInit(RFlatTableCore& table);
+
+// Read operation
+// Returns the value of key, nullptr if not found.
+inline void* rFlatTableCoreFind(const RFlatTableCore& table, uint64_t key)
+{
+	RFlatTableCore::SlotsInfo* pInfo = table.pSlotsInfo.load(std::memory_order_acquire);
+	uint64_t mixedHash = rFlatTableDetail::mixHash(key);
+	uint8_t ctrl = rFlatTableDetail::ctrlOfHash(mixedHash);
+	size_t groupMask = pInfo->nrGroupsPowerOf2 - 1;
+	size_t groupId = rFlatTableDetail::firstGroupOfHash(mixedHash, groupMask);
+	// triangular probing visits every group once
+	for (size_t iProbe = 0; iProbe <= groupMask; ++iProbe)
+	{
+		// overlap the miss of the slots with the miss of the control bytes
+		const char* pGroupSlots = (const char*)(pInfo->pSlots + groupId * c_rFlatGroupSize);
+		for (size_t offset = 0; offset < c_rFlatGroupSize * sizeof(RFlatSlot); offset += 64)
+			YJ_PREFETCH(pGroupSlots + offset);
+		rFlatTableDetail::GroupCtrls group =
+				rFlatTableDetail::loadGroup(pInfo->pCtrlWords + groupId * c_rFlatCtrlWordsPerGroup);
+		for (uint32_t match = rFlatTableDetail::matchGroup(group, ctrl); match != 0;
+				 match &= match - 1)
+		{
+			const RFlatSlot& slot = pInfo->pSlots[groupId * c_rFlatGroupSize + std::countr_zero(match)];
+			if (slot.key.load(std::memory_order_relaxed) == key)
+				return slot.pValue.load(std::memory_order_acquire);
+		}
+		if (rFlatTableDetail::matchGroup(group, c_rFlatCtrlEmpty) != 0)
+			return nullptr;
+		groupId = (groupId + iProbe + 1) & groupMask;
+	}
+	return nullptr;
+}
+
+// Write operation: all writers must be serialized
+// Returns false if the key already exists. Rehash if necessary.
+bool rFlatTableCoreTryInsert(RFlatTableCore& table, RCUZone& zone, uint64_t key, void* pValue);
+
+// Write operation: all writers must be serialized
+// Returns the value of the erased key or nullptr. rcuSynchronize is called internally and it is
+// safe to delete the value.
+void* rFlatTableCoreTryDetachAndSynchronize(RFlatTableCore& table, RCUZone& zone, uint64_t key);
+
+//////////////////////////////////////////////////////////////
+//---------------RFlatTable (with its own RCUZone)----------//
+//////////////////////////////////////////////////////////////
+void rFlatTableInit(RFlatTable& table, size_t nrSlots = 64);
+
+// same semantics as rTableReadLock/rTableReadUnlock
+int64_t rFlatTableReadLock(RFlatTable& table);
+void rFlatTableReadUnlock(RFlatTable& table, int64_t epoch);
+struct RFlatTableReadLockGuard
+{
+	explicit RFlatTableReadLockGuard(RFlatTable& table) : tbl{ table }
+	{
+		epoch = rFlatTableReadLock(table);
+	}
+	RFlatTableReadLockGuard(const RFlatTableReadLockGuard&) = delete;
+	RFlatTableReadLockGuard(RFlatTableReadLockGuard&&) = delete;
+	RFlatTableReadLockGuard& operator=(const RFlatTableReadLockGuard&) = delete;
+	RFlatTableReadLockGuard& operator=(RFlatTableReadLockGuard&&) = delete;
+
+	~RFlatTableReadLockGuard()
+	{
+		rFlatTableReadUnlock(tbl, epoch);
+	}
+	RFlatTable& tbl;
+	int64_t epoch = 0;
+};
+
+inline void* rFlatTableFind(const RFlatTable& table, uint64_t key)
+{
+	return rFlatTableCoreFind(table.core, key);
+}
+
+bool rFlatTableTryInsert(RFlatTable& table, uint64_t key, void* pValue);
+
+void* rFlatTableTryDetachNoSynchronize(RFlatTable& table, uint64_t key);
+
+void rFlatTableSynchronize(RFlatTable& table);
+
+void* rFlatTableTryDetachAndSynchronize(RFlatTable& table, uint64_t key);
+}	 // namespace yrcu
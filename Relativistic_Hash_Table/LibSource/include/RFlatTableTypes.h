@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "RCUTypes.h"
+namespace yrcu
+{
+// Open addressing table for integer (or up to 8 bytes) keys.
+// Slots are organized in groups of c_rFlatGroupSize. Every slot has one control byte, and the
+// control bytes of a group are probed together with one simd compare.
+constexpr size_t c_rFlatGroupSize = 16;
+constexpr size_t c_rFlatCtrlWordsPerGroup = c_rFlatGroupSize / sizeof(uint64_t);
+
+// control byte values, a full slot stores the low 7 bits of the mixed hash
+constexpr uint8_t c_rFlatCtrlEmpty = 0x80;
+// erased and a grace period has passed, the slot can be reused by the writer
+constexpr uint8_t c_rFlatCtrlDeleted = 0xFE;
+// erased, but readers might still be reading the slot, cannot be reused yet
+constexpr uint8_t c_rFlatCtrlRetired = 0xFF;
+
+struct RFlatSlot
+{
+	std::atomic<uint64_t> key;
+	std::atomic<void*> pValue;
+};
+
+// RFlatTableCore does not include the RCUZone and thus is feasible for shared RCUZone
+struct RFlatTableCore
+{
+	~RFlatTableCore();
+
+	struct SlotsInfo
+	{
+		size_t nrGroupsPowerOf2;
+		// c_rFlatCtrlWordsPerGroup words per group, control byte i of a group is byte (i % 8) of
+		// word (i / 8). Stored as words so that readers can load them atomically.
+		std::atomic<uint64_t>* pCtrlWords;
+		RFlatSlot* pSlots;
+	};
+
+	std::atomic<size_t> size = 0;
+	// deleted and retired slots, they count for the load factor until they are reused or rehashed
+	size_t nrTombstones = 0;
+	// retired slot indices waiting for a grace period to become deleted (reusable)
+	std::vector<size_t> retiredSlots;
+
+	// rehash when (size + nrTombstones) / slots-count grows over this factor
+	float maxLoadFactor = 0.875f;
+
+	std::atomic<SlotsInfo*> pSlotsInfo = nullptr;
+};
+
+struct RFlatTable
+{
+	RFlatTableCore core;
+	RCUZone rcuZone;
+};
+}	 // namespace yrcu
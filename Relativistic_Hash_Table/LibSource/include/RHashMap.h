@@ -0,0 +1,163 @@
+#pragma once
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "RCUHashTableApi.h"
+#include "RcuSinglyLinkedListApi.h"
+
+namespace yrcu
+{
+// Typed map on top of RTable. The map owns its nodes, key and value are stored inline right
+// after the RNode, so that the key compare of a lookup hits the cache line of the node.
+// Same threading rules as RTable: readers run concurrently with one writer at a time, and the
+// pointers returned by find are only valid inside the read critical session.
+template<typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+struct RHashMap
+{
+	struct Node
+	{
+		RNode entry;
+		K key;
+		V value;
+	};
+
+	explicit RHashMap(int nrBuckets = 64)
+	{
+		rTableInit(table, nrBuckets);
+	}
+
+	explicit RHashMap(const RTableConfig& conf)
+	{
+		rTableInitDetailed(table, conf);
+	}
+
+	RHashMap(const RHashMap&) = delete;
+	RHashMap(RHashMap&&) = delete;
+	RHashMap& operator=(const RHashMap&) = delete;
+	RHashMap& operator=(RHashMap&&) = delete;
+
+	// no readers or writers are allowed to be running
+	~RHashMap()
+	{
+		freeRetired();
+		auto* pInfo = table.core.pBucketsInfo.load(std::memory_order_relaxed);
+		for (size_t iBucket = 0; iBucket < pInfo->nrBucketsPowerOf2; ++iBucket)
+		{
+			RcuSlistHead* p = pInfo->pBuckets[iBucket].list.head.next.load(std::memory_order_relaxed);
+			while (p != nullptr)
+			{
+				RcuSlistHead* pNext = p->next.load(std::memory_order_relaxed);
+				delete YJ_CONTAINER_OF(YJ_CONTAINER_OF(p, RNode, head), Node, entry);
+				p = pNext;
+			}
+		}
+	}
+
+	struct ReadLockGuard
+	{
+		explicit ReadLockGuard(RHashMap& map) : l{ map.table }
+		{
+		}
+		RTableReadLockGuard l;
+	};
+
+	// Read operation: returns nullptr if not found
+	const V* find(const K& key) const
+	{
+		RNode* pEntry = rTableFind(
+				table,
+				hasher(key),
+				[&](const RNode* p) { return equal(YJ_CONTAINER_OF(p, Node, entry)->key, key); });
+		return pEntry ? &YJ_CONTAINER_OF(pEntry, Node, entry)->value : nullptr;
+	}
+
+	// Write operation: returns false (and drops key and value) if the key already exists.
+	// The node is only allocated if the key is new.
+	template<typename KArg, typename VArg>
+	bool insert(KArg&& key, VArg&& value)
+	{
+		K k(std::forward<KArg>(key));
+		bool inserted = false;
+		rTableFindOrInsert(
+				table,
+				hasher(k),
+				[&](const RNode* p) { return equal(YJ_CONTAINER_OF(p, Node, entry)->key, k); },
+				[&]()
+				{ return &(new Node{ RNode{}, std::move(k), V(std::forward<VArg>(value)) })->entry; },
+				&inserted);
+		return inserted;
+	}
+
+	// Write operation: waits for a grace period (a single one, also if the table shrinks) and
+	// frees the node, and the ones of earlier eraseDeferred calls
+	bool erase(const K& key)
+	{
+		Node* pNode = detach(key);
+		if (pNode == nullptr)
+			return false;
+		retired.push_back(pNode);
+		if (!shrinkIfNecessary())
+			rTableSynchronize(table);
+		freeRetired();
+		return true;
+	}
+
+	// Write operation: the node is freed by a later reclaim (or erase, or a shrinking
+	// eraseDeferred), so that several erases share one grace period
+	bool eraseDeferred(const K& key)
+	{
+		Node* pNode = detach(key);
+		if (pNode == nullptr)
+			return false;
+		retired.push_back(pNode);
+		// the grace period of a shrink covers the retired nodes too
+		if (shrinkIfNecessary())
+			freeRetired();
+		return true;
+	}
+
+	// Write operation: waits for a grace period and frees all the nodes of eraseDeferred
+	void reclaim()
+	{
+		if (retired.empty())
+			return;
+		rTableSynchronize(table);
+		freeRetired();
+	}
+
+	size_t size() const
+	{
+		return table.core.size.load(std::memory_order_relaxed);
+	}
+
+	RTable table;
+
+private:
+	Node* detach(const K& key)
+	{
+		RNode* pEntry = rTableTryDetachNoShrink(
+				table,
+				hasher(key),
+				[&](const RNode* p) { return equal(YJ_CONTAINER_OF(p, Node, entry)->key, key); });
+		return pEntry ? YJ_CONTAINER_OF(pEntry, Node, entry) : nullptr;
+	}
+
+	// returns if the shrink waited for a grace period
+	bool shrinkIfNecessary()
+	{
+		return rTableCoreDetail::shrinkBucketsToFit(table.core, table.rcuZone);
+	}
+
+	void freeRetired()
+	{
+		for (Node* pNode : retired)
+			delete pNode;
+		retired.clear();
+	}
+
+	Hash hasher;
+	Eq equal;
+	std::vector<Node*> retired;
+};
+}	 // namespace yrcu
@@ -0,0 +1,180 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace yrcu
+{
+// Multiply-xorshift finalizer (the one of MurmurHash3): every input bit affects every output
+// bit, so sequential or strided integer keys spread over all the buckets.
+inline uint64_t rHashMix64(uint64_t key)
+{
+	uint64_t h = key;
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDull;
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53ull;
+	h ^= h >> 33;
+	return h;
+}
+
+namespace rHashDetail
+{
+	constexpr uint64_t c_secret[4] = { 0x2d358dccaa6c78a5ull,
+																		 0x8bb84b93962eacc9ull,
+																		 0x4b33a62ed433d4a3ull,
+																		 0x4d5a2da51de1aa47ull };
+
+	// 64x64 -> 128 bit multiply, *pA receives the low and *pB the high half
+	inline void mum(uint64_t* pA, uint64_t* pB)
+	{
+#if defined(__SIZEOF_INT128__)
+		__uint128_t r = (__uint128_t)*pA * *pB;
+		*pA = (uint64_t)r;
+		*pB = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		*pA = _umul128(*pA, *pB, pB);
+#else
+		uint64_t ha = *pA >> 32, hb = *pB >> 32, la = (uint32_t)*pA, lb = (uint32_t)*pB;
+		uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+		uint64_t t = rl + (rm0 << 32);
+		uint64_t c = t < rl;
+		uint64_t lo = t + (rm1 << 32);
+		c += lo < t;
+		*pA = lo;
+		*pB = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+	}
+
+	inline uint64_t mix(uint64_t a, uint64_t b)
+	{
+		mum(&a, &b);
+		return a ^ b;
+	}
+
+	inline uint64_t read64(const uint8_t* p)
+	{
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	inline uint64_t read32(const uint8_t* p)
+	{
+		uint32_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	// 1 to 3 bytes
+	inline uint64_t read3(const uint8_t* p, size_t len)
+	{
+		return ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+	}
+}	 // namespace rHashDetail
+
+// Hash of a byte string, the wyhash construction: 16 bytes per 128 bit multiply, three
+// independent lanes for inputs over 48 bytes, and no loop at all up to 16 bytes.
+inline uint64_t rHashBytes(const void* pKey, size_t len, uint64_t seed = 0)
+{
+	using namespace rHashDetail;
+	const uint8_t* p = (const uint8_t*)pKey;
+	seed ^= mix(seed ^ c_secret[0], c_secret[1]);
+	uint64_t a;
+	uint64_t b;
+	if (len <= 16)
+	{
+		if (len >= 4)
+		{
+			a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+			b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0)
+		{
+			a = read3(p, len);
+			b = 0;
+		}
+		else
+			a = b = 0;
+	}
+	else
+	{
+		size_t i = len;
+		if (i > 48)
+		{
+			uint64_t seed1 = seed;
+			uint64_t seed2 = seed;
+			do
+			{
+				seed = mix(read64(p) ^ c_secret[1], read64(p + 8) ^ seed);
+				seed1 = mix(read64(p + 16) ^ c_secret[2], read64(p + 24) ^ seed1);
+				seed2 = mix(read64(p + 32) ^ c_secret[3], read64(p + 40) ^ seed2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16)
+		{
+			seed = mix(read64(p) ^ c_secret[1], read64(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = read64(p + i - 16);
+		b = read64(p + i - 8);
+	}
+	a ^= c_secret[1];
+	b ^= seed;
+	mum(&a, &b);
+	return mix(a ^ c_secret[0] ^ len, b ^ c_secret[1]);
+}
+
+// Hashes n byte strings, outHashes[i] = rHashBytes(keys[i], lens[i], seed).
+// Four keys per iteration: their multiply chains are independent and overlap in the pipeline,
+// which is where the time of short keys goes.
+inline void rHashBytesBatch(
+		const void* const* keys,
+		const size_t* lens,
+		size_t n,
+		uint64_t* outHashes,
+		uint64_t seed = 0)
+{
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		uint64_t h0 = rHashBytes(keys[i], lens[i], seed);
+		uint64_t h1 = rHashBytes(keys[i + 1], lens[i + 1], seed);
+		uint64_t h2 = rHashBytes(keys[i + 2], lens[i + 2], seed);
+		uint64_t h3 = rHashBytes(keys[i + 3], lens[i + 3], seed);
+		outHashes[i] = h0;
+		outHashes[i + 1] = h1;
+		outHashes[i + 2] = h2;
+		outHashes[i + 3] = h3;
+	}
+	for (; i < n; ++i)
+		outHashes[i] = rHashBytes(keys[i], lens[i], seed);
+}
+
+// hasher of integer keys, a drop in for std::hash (which is the identity on some platforms)
+struct RIntHash
+{
+	size_t operator()(uint64_t key) const
+	{
+		return (size_t)rHashMix64(key);
+	}
+};
+
+// hasher of strings, works for std::string through the string_view conversion
+struct RBytesHash
+{
+	size_t operator()(std::string_view key) const
+	{
+		return (size_t)rHashBytes(key.data(), key.size());
+	}
+};
+}	 // namespace yrcu
@@ -0,0 +1,53 @@
+#pragma once
+#include <new>
+#include <utility>
+
+#include "RCUApi.h"
+#include "RNodePoolTypes.h"
+
+namespace yrcu
+{
+//////////////////////////////////////////////////////////////
+//--------------------------Advanced API--------------------//
+//////////////////////////////////////////////////////////////
+struct RNodePoolConfig
+{
+	// size of a node, rounded up to a multiple of c_rNodePoolSlotAlignment
+	size_t nodeSize = 0;
+	size_t nrSlotsPerSlab = 256;
+	// 0 is for hardware_concurrency
+	int nrCaches = 0;
+};
+
+void rNodePoolInitDetailed(RNodePool& pool, RCUZone& zone, const RNodePoolConfig& conf);
+
+//---------------------------------------------------------------------------//
+
+////////////////////////////////////////////////////////////////
+//--------------------------------Basic API-------------------//
+////////////////////////////////////////////////////////////////
+// zone is the RCUZone protecting the readers of the nodes, e.g. RTable::rcuZone
+void rNodePoolInit(RNodePool& pool, RCUZone& zone, size_t nodeSize);
+
+// Thread safe. Returns uninitialized memory of nodeSize bytes, aligned to the cache line.
+// Reuses the slots of drained retire batches before carving a new slab.
+void* rNodePoolAllocate(RNodePool& pool);
+
+// Thread safe. For a node that no reader can reach any more, e.g. detached by
+// rTableTryDetachAndSynchronize, or never published.
+void rNodePoolFree(RNodePool& pool, void* p);
+
+// Thread safe. For a node detached without synchronize (e.g. rTableTryDetachNoShrink).
+// The slot is reused only after the grace period of the current epoch, which ends with any
+// later rcuSynchronize on the zone (the writers of the table call it regularly). The pool never
+// runs destructors, destroy the node before retiring it only if readers do not read the
+// destroyed members.
+void rNodePoolRetire(RNodePool& pool, void* p);
+
+template<typename T, typename... Args>
+T* rNodePoolNew(RNodePool& pool, Args&&... args)
+{
+	static_assert(alignof(T) <= c_rNodePoolSlotAlignment);
+	return new (rNodePoolAllocate(pool)) T(std::forward<Args>(args)...);
+}
+}	 // namespace yrcu
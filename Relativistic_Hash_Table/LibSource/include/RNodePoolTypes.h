@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "RCUTypes.h"
+namespace yrcu
+{
+constexpr size_t c_rNodePoolSlotAlignment = 64;
+
+// a free slot links the next one through its first bytes
+struct RNodePoolFreeSlot
+{
+	RNodePoolFreeSlot* pNext;
+};
+
+// slots retired while the epoch of the zone was `epoch`, reusable once the epoch has drained.
+// Readers might still read a retired slot, so it is tracked outside of its memory.
+struct RNodePoolRetireBatch
+{
+	int64_t epoch;
+	std::vector<void*> slots;
+};
+
+// Threads pick a cache by thread id hashing (like the unregistered readers of an RCUZone),
+// so that threads rarely contend on the spinlock of a cache.
+struct alignas(64) RNodePoolCache
+{
+	std::atomic<bool> locked = false;
+	RNodePoolFreeSlot* pFree = nullptr;
+	// bump allocation in the latest slab
+	char* pSlabCursor = nullptr;
+	char* pSlabEnd = nullptr;
+	// in increasing epoch order
+	std::vector<RNodePoolRetireBatch> retireBatches;
+	std::vector<void*> slabs;
+};
+
+// Pool of equally sized, cache line aligned node slots, the memory of a RTable node (or
+// anything embedding a RNode). Slots are carved out of slabs, so that nodes allocated together
+// are packed together. Retired slots are reused after a grace period of the zone.
+struct RNodePool
+{
+	~RNodePool();
+
+	RCUZone* pZone = nullptr;
+	size_t slotSize = 0;
+	size_t nrSlotsPerSlab = 0;
+	size_t nrCachesPowerOf2 = 0;
+	RNodePoolCache* pCaches = nullptr;
+};
+}	 // namespace yrcu
@@ -0,0 +1,112 @@
+#pragma once
+#include "RCUApi.h"
+#include "RCUHashTableCoreApi.h"
+#include "RShardedTableTypes.h"
+
+namespace yrcu
+{
+//////////////////////////////////////////////////////////////
+//--------------------------Advanced API--------------------//
+//////////////////////////////////////////////////////////////
+struct RShardedTableConfig
+{
+	int nrShardBits = 4;
+	int nrBucketsPerShard = 64;
+	int nrRcuBucketsForUnregisteredThreads = 128;
+	float expandFactor = 1.1f;
+	float shrinkFactor = 0.25f;
+};
+
+void rShardedTableInitDetailed(RShardedTable& table, const RShardedTableConfig& conf);
+
+// The shard is chosen by the highest nrShardBits bits of the hash, so the hash function needs
+// entropy in its high bits (std::hash of integers is the identity on some platforms and
+// would put all small keys into shard 0).
+inline size_t rShardedTableShardId(const RShardedTable& table, size_t hashVal)
+{
+	if (table.nrShardBits == 0)
+		return 0;
+	return hashVal >> (sizeof(size_t) * 8 - table.nrShardBits);
+}
+
+inline size_t rShardedTableNrShards(const RShardedTable& table)
+{
+	return size_t(1) << table.nrShardBits;
+}
+
+// Shard local maintenance, could run on a separate thread per shard.
+// Only the writers of the same shard wait for it.
+void rShardedTableExpandShard2x(RShardedTable& table, size_t shardId);
+bool rShardedTableShrinkShard2x(RShardedTable& table, size_t shardId);
+
+// sum of the sizes of all the shards
+size_t rShardedTableSize(const RShardedTable& table);
+
+//---------------------------------------------------------------------------//
+
+////////////////////////////////////////////////////////////////
+//--------------------------------Basic API-------------------//
+////////////////////////////////////////////////////////////////
+void rShardedTableInit(RShardedTable& table, int nrShardBits = 4);
+
+// one read critical session covers all the shards
+int64_t rShardedTableReadLock(RShardedTable& table);
+void rShardedTableReadUnlock(RShardedTable& table, int64_t epoch);
+struct RShardedTableReadLockGuard
+{
+	explicit RShardedTableReadLockGuard(RShardedTable& table) : tbl{ table }
+	{
+		epoch = rShardedTableReadLock(table);
+	}
+	RShardedTableReadLockGuard(const RShardedTableReadLockGuard&) = delete;
+	RShardedTableReadLockGuard(RShardedTableReadLockGuard&&) = delete;
+	RShardedTableReadLockGuard& operator=(const RShardedTableReadLockGuard&) = delete;
+	RShardedTableReadLockGuard& operator=(RShardedTableReadLockGuard&&) = delete;
+
+	~RShardedTableReadLockGuard()
+	{
+		rShardedTableReadUnlock(tbl, epoch);
+	}
+	RShardedTable& tbl;
+	int64_t epoch = 0;
+};
+
+// Read operation, same semantics as rTableFind
+template<typename Op>
+RNode* rShardedTableFind(const RShardedTable& table, size_t hashVal, Op matchOp)
+{
+	const RTableShard& shard = table.pShards[rShardedTableShardId(table, hashVal)];
+	return rTableCoreFind(shard.core, hashVal, matchOp);
+}
+
+// Write operation: writers are serialized per shard internally, writers of different shards
+// run in parallel. Same semantics as rTableTryInsert, only the shard is expanded if necessary.
+template<typename Op>
+bool rShardedTableTryInsert(RShardedTable& table, RNode* pEntry, size_t hashVal, Op matchOp)
+{
+	RTableShard& shard = table.pShards[rShardedTableShardId(table, hashVal)];
+	std::lock_guard<std::mutex> l{ shard.writerMutex };
+	return rTableCoreTryInsert(shard.core, table.rcuZone, pEntry, hashVal, matchOp);
+}
+
+// Write operation: writers are serialized per shard internally.
+// Same semantics as rTableTryDetachAndSynchronize. The grace period is waited for after
+// releasing the shard's writer lock, so that other writers of the shard are not blocked by it.
+template<typename Op>
+RNode* rShardedTableTryDetachAndSynchronize(RShardedTable& table, size_t hashVal, Op matchOp)
+{
+	RTableShard& shard = table.pShards[rShardedTableShardId(table, hashVal)];
+	bool ifAlreadyRcuSynchronized = false;
+	RNode* pEntry;
+	{
+		std::lock_guard<std::mutex> l{ shard.writerMutex };
+		pEntry = rTableCoreTryDetachAutoShrink(
+				shard.core, hashVal, matchOp, table.rcuZone, &ifAlreadyRcuSynchronized);
+	}
+	if (pEntry == nullptr)
+		return pEntry;
+	if (!ifAlreadyRcuSynchronized)
+		rcuSynchronize(table.rcuZone);
+	return pEntry;
+}
+}	 // namespace yrcu
@@ -0,0 +1,26 @@
+#pragma once
+#include <mutex>
+
+#include "RCUHashTableTypes.h"
+#include "RCUTypes.h"
+namespace yrcu
+{
+// One shard of a RShardedTable: an independent RTableCore with its own writer lock, size and
+// resize. The shard's RCUZone is the shared one of the sharded table.
+struct alignas(64) RTableShard
+{
+	RTableCore core;
+	std::mutex writerMutex;
+};
+
+// 2^nrShardBits shards selected by the highest bits of the hash, while the buckets inside a
+// shard are selected by the lowest bits. Readers of all the shards take a single read lock.
+struct RShardedTable
+{
+	~RShardedTable();
+
+	int nrShardBits = 0;
+	RTableShard* pShards = nullptr;
+	RCUZone rcuZone;
+};
+}	 // namespace yrcu
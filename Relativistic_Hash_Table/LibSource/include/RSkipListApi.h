@@ -0,0 +1,212 @@
+#pragma once
+#include "RCUApi.h"
+#include "RSkipListTypes.h"
+#include "RcuSinglyLinkedListApi.h"
+
+namespace yrcu
+{
+namespace rSkipListDetail
+{
+	inline RSkipLink* linkOf(RSkipList& list, RSkipNode* pNode, int level)
+	{
+		if (pNode == nullptr)
+			return &list.heads[level];
+		return level == 0 ? &pNode->level0 : &pNode->pUpperLinks[level - 1];
+	}
+
+	// Fills outPreds[level] with the last link before the first node that is not less than the
+	// key, for every level in use. lessThanKey has signature bool(const RSkipNode*).
+	// Returns the first node that is not less than the key, nullptr if there is none.
+	template<typename LessThanKey>
+	RSkipNode* findPredecessors(
+			const RSkipList& list,
+			LessThanKey lessThanKey,
+			RSkipLink** outPreds,
+			std::memory_order order)
+	{
+		RSkipList& mutableList = const_cast<RSkipList&>(list);
+		RSkipNode* pPredNode = nullptr;
+		RSkipNode* pFound = nullptr;
+		for (int level = list.nrLevels.load(std::memory_order_acquire) - 1; level >= 0; --level)
+		{
+			RSkipLink* pPred = linkOf(mutableList, pPredNode, level);
+			// the next of the predecessor is loaded once, a writer might insert behind it meanwhile
+			RcuSlistHead* pNext = pPred->head.next.load(order);
+			for (; pNext != nullptr; pNext = pPred->head.next.load(order))
+			{
+				RSkipLink* pNextLink = YJ_CONTAINER_OF(pNext, RSkipLink, head);
+				if (!lessThanKey(pNextLink->pNode))
+					break;
+				pPred = pNextLink;
+			}
+			pPredNode = pPred->pNode;
+			if (outPreds)
+				outPreds[level] = pPred;
+			pFound = pNext ? YJ_CONTAINER_OF(pNext, RSkipLink, head)->pNode : nullptr;
+		}
+		return pFound;
+	}
+
+	// writer side, links pNode after outPreds of findPredecessors
+	void link(RSkipList& list, RSkipNode* pNode, RSkipLink** preds);
+	// writer side, unlinks pNode (which follows preds on all its levels)
+	void unlink(RSkipList& list, RSkipNode* pNode, RSkipLink** preds);
+	void freeTower(RSkipNode* pNode);
+}	 // namespace rSkipListDetail
+
+void rSkipListInit(RSkipList& list, int nrRcuBucketsForUnregisteredThreads = 128);
+
+// same semantics as rTableReadLock/rTableReadUnlock
+int64_t rSkipListReadLock(RSkipList& list);
+void rSkipListReadUnlock(RSkipList& list, int64_t epoch);
+struct RSkipListReadLockGuard
+{
+	explicit RSkipListReadLockGuard(RSkipList& list) : l{ list }
+	{
+		epoch = rSkipListReadLock(list);
+	}
+	RSkipListReadLockGuard(const RSkipListReadLockGuard&) = delete;
+	RSkipListReadLockGuard(RSkipListReadLockGuard&&) = delete;
+	RSkipListReadLockGuard& operator=(const RSkipListReadLockGuard&) = delete;
+	RSkipListReadLockGuard& operator=(RSkipListReadLockGuard&&) = delete;
+
+	~RSkipListReadLockGuard()
+	{
+		rSkipListReadUnlock(l, epoch);
+	}
+	RSkipList& l;
+	int64_t epoch = 0;
+};
+
+// Read operation
+// Returns the first node that is not less than the key, nullptr if there is none.
+// lessThanKey has function signature of bool(const RSkipNode*), which returns if the node is
+// ordered before the key.
+template<typename LessThanKey>
+RSkipNode* rSkipListLowerBound(const RSkipList& list, LessThanKey lessThanKey)
+{
+	return rSkipListDetail::findPredecessors(list, lessThanKey, nullptr, std::memory_order_acquire);
+}
+
+// Read operation
+// Returns the node equal to the key or nullptr, equalsKey has signature bool(const RSkipNode*).
+template<typename LessThanKey, typename EqualsKey>
+RSkipNode* rSkipListFind(const RSkipList& list, LessThanKey lessThanKey, EqualsKey equalsKey)
+{
+	RSkipNode* pNode = rSkipListLowerBound(list, lessThanKey);
+	return pNode && equalsKey(pNode) ? pNode : nullptr;
+}
+
+// Read operation: the smallest node or nullptr
+inline RSkipNode* rSkipListFirst(const RSkipList& list)
+{
+	RcuSlistHead* pFirst = list.heads[0].head.next.load(std::memory_order_acquire);
+	return pFirst ? YJ_CONTAINER_OF(pFirst, RSkipLink, head)->pNode : nullptr;
+}
+
+// Read operation: the next node in order or nullptr. Valid on a node that was erased meanwhile,
+// it continues with a node that was behind it.
+inline RSkipNode* rSkipListNext(const RSkipNode* pNode)
+{
+	RcuSlistHead* pNext = pNode->level0.head.next.load(std::memory_order_acquire);
+	return pNext ? YJ_CONTAINER_OF(pNext, RSkipLink, head)->pNode : nullptr;
+}
+
+// Read operation
+// Calls fn (bool(RSkipNode*)) on the nodes in order, starting from the lower bound of the key,
+// until fn returns false or the list ends. Returns the number of visited nodes.
+template<typename LessThanKey, typename Fn>
+size_t rSkipListForEachFrom(const RSkipList& list, LessThanKey lessThanKey, Fn fn)
+{
+	size_t nrVisited = 0;
+	for (RSkipNode* pNode = rSkipListLowerBound(list, lessThanKey); pNode != nullptr;
+			 pNode = rSkipListNext(pNode))
+	{
+		++nrVisited;
+		if (!fn(pNode))
+			break;
+	}
+	return nrVisited;
+}
+
+// Write operation: all writers must be serialized
+// less has function signature of bool(const RSkipNode*, const RSkipNode*).
+// Returns false if an equal node exists.
+template<typename Less>
+bool rSkipListTryInsert(RSkipList& list, RSkipNode* pNode, Less less)
+{
+	RSkipLink* preds[c_rSkipListMaxLevels];
+	RSkipNode* pFound = rSkipListDetail::findPredecessors(
+			list,
+			[&](const RSkipNode* p) { return less(p, pNode); },
+			preds,
+			std::memory_order_relaxed);
+	if (pFound && !less(pNode, pFound))
+		return false;
+	rSkipListDetail::link(list, pNode, preds);
+	return true;
+}
+
+// Write operation: all writers must be serialized
+// Unlinks the node equal to the key, waits for the readers and frees its tower. Returns the node,
+// which is safe to free, or nullptr.
+template<typename LessThanKey, typename EqualsKey>
+RSkipNode* rSkipListTryDetachAndSynchronize(
+		RSkipList& list,
+		LessThanKey lessThanKey,
+		EqualsKey equalsKey)
+{
+	RSkipLink* preds[c_rSkipListMaxLevels];
+	RSkipNode* pFound = rSkipListDetail::findPredecessors(
+			list, lessThanKey, preds, std::memory_order_relaxed);
+	if (pFound == nullptr || !equalsKey(pFound))
+		return nullptr;
+	rSkipListDetail::unlink(list, pFound, preds);
+	rcuSynchronize(list.rcuZone);
+	rSkipListDetail::freeTower(pFound);
+	return pFound;
+}
+
+// Write operation: all writers must be serialized
+// Unlinks every node from the lower bound of the key while inRange (bool(const RSkipNode*))
+// holds, waits for one grace period and calls disposer (void(RSkipNode*)) on each of them.
+// Returns the number of erased nodes.
+template<typename LessThanKey, typename InRange, typename Disposer>
+size_t rSkipListEraseRange(
+		RSkipList& list,
+		LessThanKey lessThanKey,
+		InRange inRange,
+		Disposer disposer)
+{
+	RSkipLink* preds[c_rSkipListMaxLevels];
+	RSkipNode* pNode = rSkipListDetail::findPredecessors(
+			list, lessThanKey, preds, std::memory_order_relaxed);
+	RSkipNode* pFirst = pNode;
+	size_t nrErased = 0;
+	// the preds stay valid: they are before the range, and every unlinked node is their next
+	for (; pNode != nullptr && inRange(pNode); ++nrErased)
+	{
+		RSkipNode* pNext = rSkipListNext(pNode);
+		rSkipListDetail::unlink(list, pNode, preds);
+		pNode = pNext;
+	}
+	if (nrErased == 0)
+		return 0;
+	rcuSynchronize(list.rcuZone);
+	// the unlinked nodes still chain to each other on level 0
+	pNode = pFirst;
+	for (size_t i = 0; i < nrErased; ++i)
+	{
+		RSkipNode* pNext = rSkipListNext(pNode);
+		rSkipListDetail::freeTower(pNode);
+		disposer(pNode);
+		pNode = pNext;
+	}
+	return nrErased;
+}
+
+inline size_t rSkipListSize(const RSkipList& list)
+{
+	return list.size.load(std::memory_order_relaxed);
+}
+}	 // namespace yrcu
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "RCUTypes.h"
+#include "RcuSinglyLinkedListTypes.h"
+namespace yrcu
+{
+constexpr int c_rSkipListMaxLevels = 32;
+
+struct RSkipNode;
+
+// one level of a tower: the RcuSlist link of the level and the node owning it
+struct RSkipLink
+{
+	RcuSlistHead head;
+	RSkipNode* pNode;
+};
+
+// Node of a RSkipList, embedded into the user data like RNode.
+// Level 0 is linked inline and holds every node in order, the upper levels are shortcuts.
+struct RSkipNode
+{
+	RSkipLink level0;
+	int nrLevels;
+	// links of the levels 1 to nrLevels - 1, allocated by the list on insert and freed after
+	// the grace period of the erase
+	RSkipLink* pUpperLinks;
+};
+
+// Ordered list with lock free readers and serialized writers. Each level is an RcuSlist, a node
+// is linked bottom up and unlinked top down, so that a reader standing anywhere on a tower can
+// always continue downwards and forwards.
+struct RSkipList
+{
+	// frees the towers of the nodes still in the list, which must be alive at this point
+	~RSkipList();
+
+	// tower of the list head, pNode is nullptr
+	RSkipLink heads[c_rSkipListMaxLevels] = {};
+	// levels in use, readers start searching from the top one
+	std::atomic<int> nrLevels = 1;
+	std::atomic<size_t> size = 0;
+	// random tower heights, only used by the writer
+	uint64_t rngState = 0x9E3779B97F4A7C15ull;
+	RCUZone rcuZone;
+};
+}	 // namespace yrcu
@@ -0,0 +1,260 @@
+#pragma once
+#include <bit>
+
+#include "RCUApi.h"
+#include "RSplitTableTypes.h"
+#include "RcuSinglyLinkedListApi.h"
+
+namespace yrcu
+{
+namespace rSplitTableDetail
+{
+	static_assert(sizeof(size_t) == 8, "split ordered keys assume a 64 bit size_t");
+
+	inline size_t reverseBits(size_t v)
+	{
+		v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+		v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+		v = ((v >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((v & 0x0F0F0F0F0F0F0F0Full) << 4);
+		v = ((v >> 8) & 0x00FF00FF00FF00FFull) | ((v & 0x00FF00FF00FF00FFull) << 8);
+		v = ((v >> 16) & 0x0000FFFF0000FFFFull) | ((v & 0x0000FFFF0000FFFFull) << 16);
+		return (v >> 32) | (v << 32);
+	}
+
+	// the highest bit of the hash is dropped to make room for the user node marker
+	inline size_t regularKey(size_t hashVal)
+	{
+		return reverseBits(hashVal) | 1;
+	}
+
+	inline size_t dummyKey(size_t bucket)
+	{
+		return reverseBits(bucket);
+	}
+
+	inline bool isDummy(const RSplitNode* p)
+	{
+		return (p->soKey & 1) == 0;
+	}
+
+	inline size_t segmentOfBucket(size_t bucket)
+	{
+		if (bucket < c_rSplitFirstSegmentSize)
+			return 0;
+		return std::bit_width(bucket) - c_rSplitLog2FirstSegment;
+	}
+
+	inline size_t segmentBase(size_t segment)
+	{
+		return segment == 0 ? 0 : c_rSplitFirstSegmentSize << (segment - 1);
+	}
+
+	// the parent bucket has the highest bit cleared, its dummy sorts before the bucket's nodes
+	inline size_t parentBucket(size_t bucket)
+	{
+		return bucket & ~(size_t(1) << (std::bit_width(bucket) - 1));
+	}
+
+	// Read operation: the dummy of the bucket or of its closest initialized ancestor
+	inline RSplitNode* loadBucketStart(const RSplitTableCore& table, size_t bucket)
+	{
+		while (true)
+		{
+			size_t segment = segmentOfBucket(bucket);
+			std::atomic<RSplitNode*>* pSegment =
+					table.pSegments[segment].load(std::memory_order_acquire);
+			if (pSegment != nullptr)
+			{
+				RSplitNode* pDummy =
+						pSegment[bucket - segmentBase(segment)].load(std::memory_order_acquire);
+				if (pDummy != nullptr)
+					return pDummy;
+			}
+			// bucket 0 is always initialized
+			bucket = parentBucket(bucket);
+		}
+	}
+
+	// Write operation: creates the dummies of the bucket and its ancestors if necessary
+	RSplitNode* initializedBucketStart(RSplitTableCore& table, size_t bucket);
+
+	void expandIfNecessary(RSplitTableCore& table, size_t nrElements);
+
+	// Write operation: the last node of the bucket's range whose soKey is smaller than soKey
+	inline RcuSlistHead* findPredecessor(RSplitTableCore& table, size_t hashVal, size_t soKey)
+	{
+		size_t mask = table.nrBucketsPowerOf2.load(std::memory_order_relaxed) - 1;
+		RcuSlistHead* pPrev = &initializedBucketStart(table, hashVal & mask)->head;
+		for (RcuSlistHead* p = pPrev->next.load(std::memory_order_relaxed); p != nullptr;
+				 p = p->next.load(std::memory_order_relaxed))
+		{
+			if (YJ_CONTAINER_OF(p, RSplitNode, head)->soKey >= soKey)
+				break;
+			pPrev = p;
+		}
+		return pPrev;
+	}
+}	 // namespace rSplitTableDetail
+
+//////////////////////////////////////////////
+//         Advanced API
+/////////////////////////////////////////////
+struct RSplitTableCoreConfig
+{
+	int nrBuckets = 64;
+	float expandFactor = 1.1f;
+};
+
+void rSplitTableCoreInitDetailed(RSplitTableCore& table, const RSplitTableCoreConfig& conf);
+
+// Write operation: all writers must be serialized
+// Only adds buckets, no node is moved and no grace period is needed.
+// The table never shrinks, the dummies of the buckets stay until destruction.
+void rSplitTableCoreExpandBuckets2x(RSplitTableCore& table);
+
+// Write operation: all writers must be serialized
+// Same as rTableCoreTryDetachNoShrink, call rcuSynchronize before freeing the node.
+template<typename Op>
+RSplitNode* rSplitTableCoreTryDetachNoSynchronize(
+		RSplitTableCore& table,
+		size_t hashVal,
+		Op matchOp)
+{
+	size_t soKey = rSplitTableDetail::regularKey(hashVal);
+	RcuSlistHead* pPrev = rSplitTableDetail::findPredecessor(table, hashVal, soKey);
+	for (RcuSlistHead* p = pPrev->next.load(std::memory_order_relaxed); p != nullptr;
+			 p = p->next.load(std::memory_order_relaxed))
+	{
+		RSplitNode* pNode = YJ_CONTAINER_OF(p, RSplitNode, head);
+		if (pNode->soKey != soKey)
+			return nullptr;
+		if (matchOp(pNode))
+		{
+			// readers on the node still find their way through its next
+			pPrev->next.store(p->next.load(std::memory_order_relaxed), std::memory_order_release);
+			table.size.fetch_sub(1, std::memory_order_relaxed);
+			return pNode;
+		}
+		pPrev = p;
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------//
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Basic API
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void rSplitTableCoreInit(RSplitTableCore& table, int nrBuckets = 64);
+
+// Read operation, same semantics as rTableCoreFind
+// Op should have function signature of bool(RSplitNode*)
+template<typename Op>
+RSplitNode* rSplitTableCoreFind(const RSplitTableCore& table, size_t hashVal, Op matchOp)
+{
+	size_t soKey = rSplitTableDetail::regularKey(hashVal);
+	size_t mask = table.nrBucketsPowerOf2.load(std::memory_order_acquire) - 1;
+	RSplitNode* pStart = rSplitTableDetail::loadBucketStart(table, hashVal & mask);
+	for (RcuSlistHead* p = pStart->head.next.load(std::memory_order_acquire); p != nullptr;
+			 p = p->next.load(std::memory_order_acquire))
+	{
+		RSplitNode* pNode = YJ_CONTAINER_OF(p, RSplitNode, head);
+		// sorted, the nodes of the hash are all behind us
+		if (pNode->soKey > soKey)
+			return nullptr;
+		if (pNode->soKey == soKey && matchOp(pNode))
+			return pNode;
+	}
+	return nullptr;
+}
+
+// Write operation: all writers must be serialized
+// Op is of function signature of bool(RSplitNode* p0, RSplitNode* p1). Expand if necessary,
+// which never needs a grace period.
+template<typename Op>
+bool rSplitTableCoreTryInsert(
+		RSplitTableCore& table,
+		RSplitNode* pEntry,
+		size_t hashVal,
+		Op matchOp)
+{
+	size_t soKey = rSplitTableDetail::regularKey(hashVal);
+	RcuSlistHead* pPrev = rSplitTableDetail::findPredecessor(table, hashVal, soKey);
+	// insert behind the nodes of the same key
+	for (RcuSlistHead* p = pPrev->next.load(std::memory_order_relaxed); p != nullptr;
+			 p = p->next.load(std::memory_order_relaxed))
+	{
+		RSplitNode* pNode = YJ_CONTAINER_OF(p, RSplitNode, head);
+		if (pNode->soKey != soKey)
+			break;
+		if (matchOp(pNode, pEntry))
+			return false;
+		pPrev = p;
+	}
+	pEntry->soKey = soKey;
+	rcuSlistInsertAfter(pPrev, &pEntry->head);
+	size_t nrElements = table.size.fetch_add(1, std::memory_order_relaxed) + 1;
+	rSplitTableDetail::expandIfNecessary(table, nrElements);
+	return true;
+}
+
+// Write operation: all writers must be serialized
+// rcuSynchronize is called internally and it is safe to delete resource of RSplitNode.
+template<typename Op>
+RSplitNode* rSplitTableCoreTryDetachAndSynchronize(
+		RSplitTableCore& table,
+		RCUZone& zone,
+		size_t hashVal,
+		Op matchOp)
+{
+	RSplitNode* pNode = rSplitTableCoreTryDetachNoSynchronize(table, hashVal, matchOp);
+	if (pNode != nullptr)
+		rcuSynchronize(zone);
+	return pNode;
+}
+
+//////////////////////////////////////////////////////////////
+//--------------RSplitTable (with its own RCUZone)----------//
+//////////////////////////////////////////////////////////////
+void rSplitTableInit(RSplitTable& table, int nrBuckets = 64);
+
+// same semantics as rTableReadLock/rTableReadUnlock
+int64_t rSplitTableReadLock(RSplitTable& table);
+void rSplitTableReadUnlock(RSplitTable& table, int64_t epoch);
+struct RSplitTableReadLockGuard
+{
+	explicit RSplitTableReadLockGuard(RSplitTable& table) : tbl{ table }
+	{
+		epoch = rSplitTableReadLock(table);
+	}
+	RSplitTableReadLockGuard(const RSplitTableReadLockGuard&) = delete;
+	RSplitTableReadLockGuard(RSplitTableReadLockGuard&&) = delete;
+	RSplitTableReadLockGuard& operator=(const RSplitTableReadLockGuard&) = delete;
+	RSplitTableReadLockGuard& operator=(RSplitTableReadLockGuard&&) = delete;
+
+	~RSplitTableReadLockGuard()
+	{
+		rSplitTableReadUnlock(tbl, epoch);
+	}
+	RSplitTable& tbl;
+	int64_t epoch = 0;
+};
+
+template<typename Op>
+RSplitNode* rSplitTableFind(const RSplitTable& table, size_t hashVal, Op matchOp)
+{
+	return rSplitTableCoreFind(table.core, hashVal, matchOp);
+}
+
+template<typename Op>
+bool rSplitTableTryInsert(RSplitTable& table, RSplitNode* pEntry, size_t hashVal, Op matchOp)
+{
+	return rSplitTableCoreTryInsert(table.core, pEntry, hashVal, matchOp);
+}
+
+template<typename Op>
+RSplitNode* rSplitTableTryDetachAndSynchronize(RSplitTable& table, size_t hashVal, Op matchOp)
+{
+	return rSplitTableCoreTryDetachAndSynchronize(table.core, table.rcuZone, hashVal, matchOp);
+}
+}	 // namespace yrcu
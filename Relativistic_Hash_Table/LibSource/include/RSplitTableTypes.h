@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+
+#include "RCUTypes.h"
+#include "RcuSinglyLinkedListTypes.h"
+namespace yrcu
+{
+// Node of a split ordered table, embedded into the user data like RNode.
+// All the nodes live in one list sorted by soKey, the bit reversed hash. The buckets only hold
+// shortcuts into the list (dummy nodes), so growing the bucket count never relinks any node.
+struct RSplitNode
+{
+	// set by the table: bit reversed hash, the lowest bit is set for user nodes and cleared for
+	// the dummy nodes of the buckets
+	size_t soKey;
+	RcuSlistHead head;
+};
+
+constexpr size_t c_rSplitLog2FirstSegment = 6;
+constexpr size_t c_rSplitFirstSegmentSize = size_t(1) << c_rSplitLog2FirstSegment;
+// segment 0 holds the first c_rSplitFirstSegmentSize buckets, segment s > 0 holds the buckets
+// [c_rSplitFirstSegmentSize << (s - 1), c_rSplitFirstSegmentSize << s)
+constexpr size_t c_rSplitMaxSegments = sizeof(size_t) * 8 - c_rSplitLog2FirstSegment;
+
+// RSplitTableCore does not include the RCUZone and thus is feasible for shared RCUZone
+struct RSplitTableCore
+{
+	~RSplitTableCore();
+
+	std::atomic<size_t> size = 0;
+	// only grows, a segment is published before the bucket count covering it
+	std::atomic<size_t> nrBucketsPowerOf2 = 0;
+	// the dummy node of a bucket is created by the first writer visiting the bucket, readers
+	// fall back to the parent bucket (highest bit cleared) of an uninitialized bucket
+	std::atomic<std::atomic<RSplitNode*>*> pSegments[c_rSplitMaxSegments] = {};
+
+	// double the bucket count when element/buckets-count grows over this factor
+	float expandFactor = 1.1f;
+};
+
+struct RSplitTable
+{
+	RSplitTableCore core;
+	RCUZone rcuZone;
+};
+}	 // namespace yrcu
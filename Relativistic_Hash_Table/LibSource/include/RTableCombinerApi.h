@@ -0,0 +1,53 @@
+#pragma once
+#include "RCUHashTableApi.h"
+#include "RTableCombinerTypes.h"
+
+namespace yrcu
+{
+//////////////////////////////////////////////////////////////
+//--------------------------Advanced API--------------------//
+//////////////////////////////////////////////////////////////
+// Write operation: lock free, does not wait for op to be applied. op must not be reused before
+// its done flag is set.
+void rTableCombinerPost(RTableCombiner& comb, RTableCombinedOp& op);
+
+// Applies all the pending operations as one batch, unless another thread is already combining.
+// Returns if this thread combined. A dedicated combiner thread can simply call it in a loop.
+bool rTableCombinerTryCombine(RTableCombiner& comb);
+
+// Returns once op is applied, combining the pending operations (of all the threads) while
+// no other thread does.
+void rTableCombinerWait(RTableCombiner& comb, RTableCombinedOp& op);
+
+//---------------------------------------------------------------------------//
+
+////////////////////////////////////////////////////////////////
+//--------------------------------Basic API-------------------//
+////////////////////////////////////////////////////////////////
+// All the writes to table must go through comb from now on, the readers use table as before.
+// Not for tables with handle nodes or writer stripes.
+void rTableCombinerInit(RTableCombiner& comb, RTable& table, RTableCombinerMatchFn matchFn);
+
+// Write operation: concurrent with other combiner writers
+// Same semantics as rTableTryInsert.
+bool rTableCombinerTryInsert(
+		RTableCombiner& comb,
+		RNode* pEntry,
+		size_t hashVal,
+		const void* pKey);
+
+// Write operation: concurrent with other combiner writers
+// Same semantics as rTableTryDetachAndSynchronize, the grace period is shared with the batch.
+RNode* rTableCombinerTryDetachAndSynchronize(
+		RTableCombiner& comb,
+		size_t hashVal,
+		const void* pKey);
+
+// Write operation: concurrent with other combiner writers
+// rTableReplace followed by the (shared) grace period, the returned node can be freed.
+RNode* rTableCombinerReplaceAndSynchronize(
+		RTableCombiner& comb,
+		size_t hashVal,
+		const void* pKey,
+		RNode* pNewEntry);
+}	 // namespace yrcu
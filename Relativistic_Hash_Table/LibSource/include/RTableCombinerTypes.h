@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "RCUHashTableTypes.h"
+namespace yrcu
+{
+enum class RTableCombinedOpType
+{
+	Insert,
+	Erase,
+	Replace,
+};
+
+// returns if pNode holds the key pKey, the matchOp of all the operations of a combiner
+using RTableCombinerMatchFn = bool (*)(const RNode* pNode, const void* pKey);
+
+// One write operation posted to a RTableCombiner. Owned by the producer, which must keep it
+// (and pKey) alive until done is set.
+struct RTableCombinedOp
+{
+	RTableCombinedOpType type = RTableCombinedOpType::Insert;
+	size_t hashVal = 0;
+	const void* pKey = nullptr;
+	// Insert: the node to insert, Replace: the replacement
+	RNode* pNode = nullptr;
+	// Insert: pNode, or nullptr if the key was already in the table
+	// Erase/Replace: the detached node, or nullptr if no node matched. It is past its grace period
+	// when done is set, and can be freed right away.
+	RNode* pResult = nullptr;
+	std::atomic<bool> done = false;
+
+	// used by the combiner only
+	size_t bucketHash = 0;
+	RTableCombinedOp* pNext = nullptr;
+};
+
+// Flat combining front end of a RTable for many writer threads. Producers push their operations
+// onto a lock-free stack, and whichever thread holds the combiner role applies all the pending
+// ones as one batch: sorted by bucket, one resize check and one grace period per batch.
+struct RTableCombiner
+{
+	RTable* pTable = nullptr;
+	RTableCombinerMatchFn matchFn = nullptr;
+	alignas(64) std::atomic<RTableCombinedOp*> pPending = nullptr;
+	alignas(64) std::atomic<bool> combining = false;
+	// scratch of the combiner
+	std::vector<RTableCombinedOp*> batch;
+	std::atomic<uint64_t> nrBatches = 0;
+	std::atomic<uint64_t> nrCombinedOps = 0;
+};
+}	 // namespace yrcu
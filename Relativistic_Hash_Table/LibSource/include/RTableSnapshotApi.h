@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "RCUHashTableApi.h"
+#include "RCUHashTableCoreApi.h"
+#include "RTableSnapshotTypes.h"
+
+namespace yrcu
+{
+namespace rTableSnapshotDetail
+{
+	bool writerBegin(RTableSnapshotWriter& writer, const char* path);
+	void writerBeginChunk(RTableSnapshotWriter& writer);
+	void writerAppendRecord(
+			RTableSnapshotWriter& writer,
+			uint64_t hash,
+			const void* pPayload,
+			size_t payloadSize);
+	// writes the chunk index and the final header, and closes the file
+	bool writerFinish(RTableSnapshotWriter& writer, size_t nrBucketsPowerOf2, bool mixHash);
+
+	// maps the file and validates the header and the chunk index
+	bool mapSnapshot(RTableSnapshotMapping& mapping, const char* path);
+	void unmapSnapshot(RTableSnapshotMapping& mapping);
+
+	inline size_t recordSize(uint64_t payloadSize)
+	{
+		return sizeof(RTableSnapshotRecord) + (size_t)((payloadSize + 7) / 8 * 8);
+	}
+}	 // namespace rTableSnapshotDetail
+
+// Read operation: the caller must hold a read lock for the whole call.
+// Writes the nodes of the table in bucket order to path. serializeFn has function signature of
+// void(const RNode*, std::vector<char>& payload) and appends the payload of the node.
+// Returns false if the file could not be written.
+template<typename SerializeFn>
+bool rTableCoreSnapshot(const RTableCore& table, const char* path, SerializeFn serializeFn)
+{
+	RTableSnapshotWriter writer;
+	if (!rTableSnapshotDetail::writerBegin(writer, path))
+		return false;
+	RTableCore::BucketsInfo* pInfo = table.pBucketsInfo.load(std::memory_order_acquire);
+	size_t nrBuckets = pInfo->nrBucketsPowerOf2;
+	std::vector<char> payload;
+	auto writeNode = [&](RNode* pNode)
+	{
+		payload.clear();
+		serializeFn(static_cast<const RNode*>(pNode), payload);
+		rTableSnapshotDetail::writerAppendRecord(
+				writer, pNode->hash, payload.data(), payload.size());
+	};
+	for (size_t iBegin = 0; iBegin < nrBuckets; iBegin += c_rTableSnapshotChunkBuckets)
+	{
+		rTableSnapshotDetail::writerBeginChunk(writer);
+		size_t iEnd = std::min(iBegin + c_rTableSnapshotChunkBuckets, nrBuckets);
+		// exactly once per node, also if a resize is in progress
+		rTableCoreDetail::forEachInBuckets(pInfo, iBegin, iEnd, writeNode);
+	}
+	return rTableSnapshotDetail::writerFinish(writer, nrBuckets, table.mixHash);
+}
+
+// Read operation: see rTableCoreSnapshot. The read lock is held for the whole snapshot, readers
+// continue meanwhile, but the writers wait in their rcuSynchronize until it is done.
+template<typename SerializeFn>
+bool rTableSnapshot(RTable& table, const char* path, SerializeFn serializeFn)
+{
+	RTableReadLockGuard l(table);
+	return rTableCoreSnapshot(table.core, path, serializeFn);
+}
+
+// Builds a table from a snapshot file in one pass, at the bucket count of the snapshot and
+// without any expand. The file is mapped, and its chunks are linked by nrThreads threads.
+// table must not be initialized yet and must not be shared with other threads before the call
+// returns; conf.nrBuckets and conf.mixHash are ignored, both are taken from the snapshot.
+// deserializeFn has function signature of RNode*(const void* pPayload, size_t payloadSize),
+// creates the node of a payload and is called concurrently from nrThreads threads. The hash of
+// the node is set by the table. With conf.handleNodes, it returns the node of a RHandleNode.
+// Returns false if the file cannot be mapped or is corrupted, the table then holds the nodes
+// loaded so far.
+template<typename DeserializeFn>
+bool rTableLoad(
+		RTable& table,
+		const char* path,
+		DeserializeFn deserializeFn,
+		RTableConfig conf = {},
+		size_t nrThreads = std::thread::hardware_concurrency())
+{
+	RTableSnapshotMapping mapping;
+	if (!rTableSnapshotDetail::mapSnapshot(mapping, path))
+		return false;
+	const RTableSnapshotHeader* pHeader = (const RTableSnapshotHeader*)mapping.pData;
+	const uint64_t* pChunkOffsets = (const uint64_t*)(mapping.pData + pHeader->chunkIndexOffset);
+	conf.nrBuckets = (int)pHeader->nrBucketsPowerOf2;
+	// the records hold the stored hashes, the lookups must keep selecting the buckets the same way
+	conf.mixHash = pHeader->mixHash != 0;
+	rTableInitDetailed(table, conf);
+	RTableCore::BucketsInfo* pInfo = table.core.pBucketsInfo.load(std::memory_order_relaxed);
+	size_t bucketMask = pInfo->nrBucketsPowerOf2 - 1;
+	uint64_t snapshotBucketMask = pHeader->nrBucketsPowerOf2 - 1;
+	// the chunks only link disjoint buckets if the bucket count is the one of the snapshot (it
+	// might be raised by writer stripes)
+	if (pInfo->nrBucketsPowerOf2 != pHeader->nrBucketsPowerOf2 || nrThreads == 0)
+		nrThreads = 1;
+
+	std::atomic<size_t> nextChunk = 0;
+	std::atomic<size_t> nrLoaded = 0;
+	std::atomic<bool> corrupted = false;
+	auto worker = [&]()
+	{
+		size_t nrLoadedLocal = 0;
+		for (size_t iChunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+				 iChunk < pHeader->nrChunks;
+				 iChunk = nextChunk.fetch_add(1, std::memory_order_relaxed))
+		{
+			uint64_t endOffset = pHeader->chunkIndexOffset;
+			if (iChunk + 1 < pHeader->nrChunks)
+				endOffset = pChunkOffsets[iChunk + 1];
+			const char* p = mapping.pData + pChunkOffsets[iChunk];
+			const char* pEnd = mapping.pData + endOffset;
+			while (p < pEnd)
+			{
+				const RTableSnapshotRecord* pRecord = (const RTableSnapshotRecord*)p;
+				// payloadSize is checked before recordSize rounds it up, which would wrap near 2^64.
+				// A record of a bucket outside the chunk would race with the thread linking its chunk.
+				if ((size_t)(pEnd - p) < sizeof(RTableSnapshotRecord) ||
+						pRecord->payloadSize > (size_t)(pEnd - p) - sizeof(RTableSnapshotRecord) ||
+						(size_t)(pEnd - p) < rTableSnapshotDetail::recordSize(pRecord->payloadSize) ||
+						(pRecord->hash & snapshotBucketMask) / c_rTableSnapshotChunkBuckets != iChunk)
+				{
+					corrupted.store(true, std::memory_order_relaxed);
+					break;
+				}
+				RNode* pNode = deserializeFn(
+						(const void*)(p + sizeof(RTableSnapshotRecord)), (size_t)pRecord->payloadSize);
+				pNode->hash = (size_t)pRecord->hash;
+				rTableCoreDetail::bloomAdd(table.core, pNode->hash);
+				// no duplicates in a snapshot, and each bucket is only linked by the thread of its chunk
+				rcuSlistInsertAfter(&pInfo->pBuckets[pNode->hash & bucketMask].list.head, &pNode->head);
+				++nrLoadedLocal;
+				p += rTableSnapshotDetail::recordSize(pRecord->payloadSize);
+			}
+		}
+		nrLoaded.fetch_add(nrLoadedLocal, std::memory_order_relaxed);
+	};
+	std::vector<std::future<void>> futures(nrThreads - 1);
+	for (auto& future : futures)
+		future = std::async(std::launch::async, worker);
+	worker();
+	for (auto& future : futures)
+		future.get();
+
+	table.core.size.store(nrLoaded.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	// the chains were linked without the back pointers
+	if (table.core.handleNodes)
+		rTableCoreDetail::relinkBackPointers(table.core);
+	bool complete = !corrupted.load(std::memory_order_relaxed) && nrLoaded.load() == pHeader->nrNodes;
+	rTableSnapshotDetail::unmapSnapshot(mapping);
+	return complete;
+}
+}	 // namespace yrcu
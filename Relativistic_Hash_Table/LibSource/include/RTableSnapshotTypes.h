@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace yrcu
+{
+// Image of a RTable written by rTableSnapshot, in native byte order:
+// RTableSnapshotHeader, then the records of the nodes in bucket order, then the chunk index.
+// A record is a RTableSnapshotRecord followed by the payload, padded to 8 bytes.
+// The chunk index holds the file offset of the first record of every
+// c_rTableSnapshotChunkBuckets buckets, so that the chunks can be loaded in parallel.
+constexpr uint64_t c_rTableSnapshotMagic = 0x3230504E53425452ull;	 // "RTBSNP02"
+constexpr size_t c_rTableSnapshotChunkBuckets = 4096;
+
+struct RTableSnapshotHeader
+{
+	uint64_t magic;
+	uint64_t nrBucketsPowerOf2;
+	uint64_t nrNodes;
+	uint64_t chunkIndexOffset;
+	uint64_t nrChunks;
+	// 1 if the record hashes are mixed (RTableCore::mixHash), the loaded table mixes as well
+	uint64_t mixHash;
+};
+
+struct RTableSnapshotRecord
+{
+	uint64_t hash;
+	uint64_t payloadSize;
+};
+
+struct RTableSnapshotWriter
+{
+	FILE* pFile = nullptr;
+	uint64_t offset = 0;
+	uint64_t nrNodes = 0;
+	std::vector<uint64_t> chunkOffsets;
+	bool failed = false;
+};
+
+// read only mapping of a snapshot file
+struct RTableSnapshotMapping
+{
+	const char* pData = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* hFile = nullptr;
+	void* hMapping = nullptr;
+#endif
+};
+}	 // namespace yrcu
@@ -1,8 +1,17 @@
+#pragma once
 #include "RcuSinglyLinkedListTypes.h"
 
 #define YJ_OFFSET_OF(Type, Field)					 __builtin_offsetof(Type, Field)
 #define YJ_CONTAINER_OF(ptr, type, member) ((type*)((char*)ptr - YJ_OFFSET_OF(type, member)))
 
+// hint the cpu to pull the cache line of ptr into L1 (only a hint, never faults)
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#define YJ_PREFETCH(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#else
+#define YJ_PREFETCH(ptr) __builtin_prefetch((const void*)(ptr))
+#endif
+
 namespace yrcu
 {
 //*************** Atomic singly list **************//
@@ -145,6 +154,95 @@ RcuSlistHead* rcuSlistRemoveIf(RcuSlist* list, UnaryPredict predict)
 	return p;
 }
 
+// Write operation(must be serialized with other write operations)
+// Find the first element that matches the predict and link newElem in its position with one
+// release store of the predecessor's next, so that a reader sees either the old or the new
+// element. Returns the replaced element (with its next untouched for the readers still on it)
+// or nullptr, in which case newElem is not linked.
+template<typename UnaryPredict>
+RcuSlistHead* rcuSlistReplaceIf(RcuSlist* list, UnaryPredict predict, RcuSlistHead* newElem)
+{
+	RcuSlistHead* pLast = &list->head;
+	RcuSlistHead* p = pLast->next.load(std::memory_order_relaxed);
+	while (p)
+	{
+		if (predict(p))
+		{
+			// order of the lines below matters since there might be concurrent readers
+			newElem->next.store(p->next.load(std::memory_order_relaxed), std::memory_order_release);
+			pLast->next.store(newElem, std::memory_order_release);
+			break;
+		}
+		pLast = p;
+		p = p->next.load(std::memory_order_relaxed);
+	}
+	return p;
+}
+
+// Write operation(must be serialized with other write operations)
+// Return the first element that matches the predict, or prepend makeNew() (of signature
+// RcuSlistHead*()) and return it. makeNew is only called if nothing matched, outInserted tells
+// which of the two happened.
+template<typename UnaryPredict, typename Factory>
+RcuSlistHead*
+rcuSlistFindOrPrepend(RcuSlist* list, UnaryPredict predict, Factory makeNew, bool& outInserted)
+{
+	RcuSlistHead* pFirst = list->head.next.load(std::memory_order_relaxed);
+	for (RcuSlistHead* p = pFirst; p != nullptr; p = p->next.load(std::memory_order_relaxed))
+		if (predict(p))
+		{
+			outInserted = false;
+			return p;
+		}
+	RcuSlistHead* newElem = makeNew();
+	// order of the lines below matters since there might be concurrent readers
+	newElem->next.store(pFirst, std::memory_order_release);
+	list->head.next.store(newElem, std::memory_order_release);
+	outInserted = true;
+	return newElem;
+}
+
+// Write operation(must be serialized with other write operations)
+// Replace the first element that matches the predict by newElem (see rcuSlistReplaceIf), or
+// prepend newElem if nothing matched. Returns the replaced element or nullptr.
+template<typename UnaryPredict>
+RcuSlistHead* rcuSlistReplaceOrPrepend(RcuSlist* list, UnaryPredict predict, RcuSlistHead* newElem)
+{
+	RcuSlistHead* pReplaced = rcuSlistReplaceIf(list, predict, newElem);
+	if (pReplaced)
+		return pReplaced;
+	// order of the lines below matters since there might be concurrent readers
+	newElem->next.store(list->head.next.load(std::memory_order_relaxed), std::memory_order_release);
+	list->head.next.store(newElem, std::memory_order_release);
+	return nullptr;
+}
+
+// Unlink every element that matches the predict in one pass, onRemoved(RcuSlistHead*) is called
+// for each of them. Same rules for the unlinked elements as rcuSlistRemoveIf: a reader might
+// still be standing on one, so its next member is left untouched.
+// Returns the number of unlinked elements.
+template<typename UnaryPredict, typename OnRemoved>
+size_t rcuSlistRemoveAllIf(RcuSlist* list, UnaryPredict predict, OnRemoved onRemoved)
+{
+	size_t nrRemoved = 0;
+	RcuSlistHead* pLast = &list->head;
+	RcuSlistHead* p = pLast->next.load(std::memory_order_relaxed);
+	while (p)
+	{
+		RcuSlistHead* pNext = p->next.load(std::memory_order_relaxed);
+		if (predict(p))
+		{
+			pLast->next.store(pNext, std::memory_order_release);
+			onRemoved(p);
+			++nrRemoved;
+		}
+		else
+			pLast = p;
+		p = pNext;
+	}
+	return nrRemoved;
+}
+
 // Head will be returned if it exists in the list
 // Otherwise, nullptr is returned
 inline RcuSlistHead* rcuSlistRemove(RcuSlist* list, RcuSlistHead* head)
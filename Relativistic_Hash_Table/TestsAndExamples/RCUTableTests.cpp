@@ -1,12 +1,29 @@
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
 #include <future>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <random>
 #include <shared_mutex>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
 #include "RCUHashTableApi.h"
+#include "RCacheApi.h"
+#include "RCompactTableApi.h"
+#include "RFlatTableApi.h"
+#include "RHashMap.h"
+#include "RNodePoolApi.h"
+#include "RShardedTableApi.h"
+#include "RSkipListApi.h"
+#include "RSplitTableApi.h"
+#include "RTableCombinerApi.h"
+#include "RTableSnapshotApi.h"
 #include "RcuDoublyLinkedListApi.h"
 #include "TestHelper.h"
 
@@ -234,7 +251,7 @@ namespace
 			}
 		}
 
-		void runRcuHashMap()
+		void runRcuHashMap(bool batched)
 		{
 			RTable rTable;
 			rTableInit(rTable);
@@ -265,10 +282,40 @@ namespace
 			}
 
 			{
-				Timer timer{ "rTable: " };
+				Timer timer{ batched ? "rTable batched find: " : "rTable: " };
 				std::vector<std::future<void>> futures{ std::thread::hardware_concurrency() };
-				auto f = [&rTable, &myData, this]()
+				auto fBatched = [&rTable, &myData, this]()
 				{
+					constexpr size_t c_batchSize = 32;
+					size_t hashVals[c_batchSize];
+					size_t keys[c_batchSize];
+					RNode* pFounds[c_batchSize];
+					for (size_t round = 0; round < c_nrRounds; ++round)
+						for (size_t start = 0; start < myData.size(); start += c_batchSize)
+						{
+							RTableReadLockGuard l(rTable);
+							for (size_t i = 0; i < c_batchSize; ++i)
+							{
+								keys[i] = myData[start + i]->value;
+								hashVals[i] = std::hash<size_t>{}(keys[i]);
+							}
+							rTableFindBatch(
+									rTable,
+									hashVals,
+									keys,
+									pFounds,
+									c_batchSize,
+									[](const RNode* p, size_t key)
+									{ return YJ_CONTAINER_OF(p, MyElement, entry)->value == key; });
+							for (size_t i = 0; i < c_batchSize; ++i)
+								if (!pFounds[i])
+									throw std::exception("Wrong");
+						}
+				};
+				auto f = [&rTable, &myData, &fBatched, batched, this]()
+				{
+					if (batched)
+						return fBatched();
 					for (size_t round = 0; round < c_nrRounds; ++round)
 						for (auto i = 0; i < myData.size(); ++i)
 						{
@@ -313,13 +360,66 @@ namespace
 			}
 		};
 
+		// same workload as runRcuHashMap, on the open addressing table
+		void runRcuFlatTable()
+		{
+			RFlatTable fTable;
+			rFlatTableInit(fTable);
+			struct MyElement
+			{
+				size_t value;
+			};
+
+			std::vector<std::unique_ptr<MyElement>> myData{ c_nrElementsToLookUp };
+			for (size_t item = 0; item < myData.size(); ++item)
+			{
+				myData[item] = std::make_unique<MyElement>();
+				myData[item]->value = item;
+				rFlatTableTryInsert(fTable, item, myData[item].get());
+			}
+
+			{
+				Timer timer{ "rFlatTable: " };
+				std::vector<std::future<void>> futures{ std::thread::hardware_concurrency() };
+				auto f = [&fTable, &myData, this]()
+				{
+					for (size_t round = 0; round < c_nrRounds; ++round)
+						for (size_t i = 0; i < myData.size(); ++i)
+						{
+							RFlatTableReadLockGuard l(fTable);
+							if (!rFlatTableFind(fTable, myData[i]->value))
+								throw std::exception("Wrong");
+						}
+				};
+
+				for (auto& myFuture : futures)
+					myFuture = std::async(std::launch::async, f);
+
+				// some seldom writing operations
+				std::vector<std::unique_ptr<MyElement>> myDataAdditional{ c_nrElementsToLookUp };
+				for (size_t i = 0; i < myData.size(); ++i)
+				{
+					if (i % 1024 != 0)
+						continue;
+					myDataAdditional[i] = std::make_unique<MyElement>();
+					myDataAdditional[i]->value = i + myData.size();
+					rFlatTableTryInsert(fTable, myDataAdditional[i]->value, myDataAdditional[i].get());
+				}
+
+				for (auto& myFuture : futures)
+					myFuture.get();
+			}
+		}
+
 		void run()
 		{
 			runStdUnorderedMapMutex<std::shared_mutex, std::shared_lock, true>("UnorderedMap read only");
 			runStdUnorderedMapMutex<std::shared_mutex, std::shared_lock, false>(
 					"UnorderedMap with std::shared_mutex");
 			runStdUnorderedMapMutex<std::mutex, std::lock_guard, false>("UnorderedMap with std::mutex");
-			runRcuHashMap();
+			runRcuHashMap(false);
+			runRcuHashMap(true);
+			runRcuFlatTable();
 		}
 	};
 
@@ -606,17 +706,2393 @@ namespace
 				throw std::exception("Broken");
 		}
 	}
-}	 // namespace
+	// bucket arrays over the threshold are mapped and not initialized by a loop
+	void RCUTableMappedBucketsTest()
+	{
+		RTable tbl;
+		RTableConfig conf;
+		conf.nrBuckets = 4;
+		conf.bucketsMmapThresholdBytes = 4096;
+		conf.bucketsInterleaveNuma = true;
+		rTableInitDetailed(tbl, conf);
 
-void rTableTests()
-{
-	RcuDlistTest dlistTest;
-	dlistTest.run();
+		struct Element
+		{
+			size_t v;
+			RNode entry;
+		};
+		const size_t size = 100000;
+		std::vector<Element> elements{ size };
+		auto equal = [](RNode* p1, RNode* p2)
+		{ return YJ_CONTAINER_OF(p1, Element, entry)->v == YJ_CONTAINER_OF(p2, Element, entry)->v; };
+		for (size_t i = 0; i < size; ++i)
+		{
+			elements[i].v = i;
+			if (!rTableTryInsert(tbl, &elements[i].entry, std::hash<size_t>{}(i), equal))
+				throw std::exception("Broken");
+		}
+		auto checkAll = [&](size_t nrExpected)
+		{
+			size_t nrFound = 0;
+			RTableReadLockGuard l(tbl);
+			for (size_t i = 0; i < size; ++i)
+				nrFound += rTableFind(
+											 tbl,
+											 std::hash<size_t>{}(i),
+											 [i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; }) !=
+									 nullptr;
+			if (nrFound != nrExpected)
+				throw std::exception("Broken");
+		};
+		checkAll(size);
+#ifdef __linux__
+		if (!tbl.core.pBucketsInfo.load()->mmapped)
+			throw std::exception("Broken");
+#endif
+		// shrink back through the mapped arrays down to malloc-ed ones
+		for (size_t i = 0; i < size; i += 2)
+			if (!rTableTryDetachAndSynchronize(
+							tbl,
+							std::hash<size_t>{}(i),
+							[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; }))
+				throw std::exception("Broken");
+		while (tbl.core.pBucketsInfo.load()->mmapped)
+			if (!rTableShrinkBuckets2x(tbl))
+				throw std::exception("Broken");
+		checkAll(size / 2);
+	}
 
-	RCUTableManualStressExpandShrink testManualShrinkExpand;
-	testManualShrinkExpand.run();
+	// every node is visited exactly once while another thread keeps resizing the table
+	void RCUTableForEachTest()
+	{
+		RTable tbl;
+		rTableInit(tbl, 64);
+		struct Element
+		{
+			size_t v;
+			RNode entry;
+			std::atomic<int> nrVisits = 0;
+		};
+		const size_t size = 20000;
+		std::vector<Element> elements{ size };
+		for (size_t i = 0; i < size; ++i)
+		{
+			elements[i].v = i;
+			rTableTryInsert(
+					tbl,
+					&elements[i].entry,
+					std::hash<size_t>{}(i),
+					[](RNode* p1, RNode* p2)
+					{
+						return YJ_CONTAINER_OF(p1, Element, entry)->v ==
+									 YJ_CONTAINER_OF(p2, Element, entry)->v;
+					});
+		}
 
-	RCUTableTestSingleThreadTest();
+		std::atomic<bool> finished = false;
+		auto resizer = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+			{
+				rTableExpandBuckets2x(tbl);
+				rTableExpandBuckets2x(tbl);
+				rTableShrinkBuckets2x(tbl);
+				rTableShrinkBuckets2x(tbl);
+			}
+		};
+		std::future<void> resizerFuture = std::async(std::launch::async, resizer);
+
+		auto visit = [](RNode* p) { YJ_CONTAINER_OF(p, Element, entry)->nrVisits.fetch_add(1); };
+		for (int round = 0; round < 20; ++round)
+		{
+			if (round % 2 == 0)
+				rTableForEach(tbl, visit);
+			else
+				rTableParallelForEach(tbl, visit, 4);
+			for (auto& element : elements)
+				if (element.nrVisits.exchange(0) != 1)
+					throw std::exception("Broken");
+		}
+		finished.store(true, std::memory_order_relaxed);
+		resizerFuture.get();
+	}
+
+	// a scan in small chunks sees every node at least once while the table is resized between
+	// the chunks
+	void RCUTableScanTest()
+	{
+		RTable tbl;
+		rTableInit(tbl, 64);
+		struct Element
+		{
+			size_t v;
+			RNode entry;
+			int nrVisits = 0;
+		};
+		const size_t size = 20000;
+		std::vector<Element> elements{ size };
+		for (size_t i = 0; i < size; ++i)
+		{
+			elements[i].v = i;
+			rTableTryInsert(
+					tbl,
+					&elements[i].entry,
+					std::hash<size_t>{}(i),
+					[](RNode* p1, RNode* p2)
+					{
+						return YJ_CONTAINER_OF(p1, Element, entry)->v ==
+									 YJ_CONTAINER_OF(p2, Element, entry)->v;
+					});
+		}
+		auto visit = [](RNode* p) { ++YJ_CONTAINER_OF(p, Element, entry)->nrVisits; };
+
+		// no resize: exactly once
+		size_t cursor = 0;
+		do
+			cursor = rTableScan(tbl, cursor, 100, visit);
+		while (cursor != 0);
+		for (auto& element : elements)
+			if (std::exchange(element.nrVisits, 0) != 1)
+				throw std::exception("Broken");
+
+		// the table is expanded or shrunk between every two chunks
+		for (int round = 0; round < 4; ++round)
+		{
+			size_t iChunk = 0;
+			do
+			{
+				cursor = rTableScan(tbl, cursor, 64, visit);
+				if ((iChunk + round) % 4 < 2)
+					rTableExpandBuckets2x(tbl);
+				else
+					rTableShrinkBuckets2x(tbl);
+				++iChunk;
+			} while (cursor != 0);
+			for (auto& element : elements)
+				if (std::exchange(element.nrVisits, 0) < 1)
+					throw std::exception("Broken");
+		}
+	}
+
+	// snapshot a table while a reader runs, and load it back into a new table
+	void RCUTableSnapshotTest()
+	{
+		struct Element
+		{
+			size_t v;
+			std::string name;
+			RNode entry;
+		};
+		auto equal = [](RNode* p1, RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->v == YJ_CONTAINER_OF(p2, Element, entry)->v;
+		};
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t size = 30000;
+		std::vector<Element> elements{ size };
+		for (size_t i = 0; i < size; ++i)
+		{
+			elements[i].v = i;
+			elements[i].name = std::string(i % 13, 'a' + i % 26);
+			rTableTryInsert(tbl, &elements[i].entry, std::hash<size_t>{}(i), equal);
+		}
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < size; i += 101)
+				{
+					RTableReadLockGuard l(tbl);
+					if (!rTableFind(
+									tbl,
+									std::hash<size_t>{}(i),
+									[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; }))
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		std::string path =
+				(std::filesystem::temp_directory_path() / "rtable_snapshot_test.bin").string();
+		bool written = rTableSnapshot(
+				tbl,
+				path.c_str(),
+				[](const RNode* p, std::vector<char>& payload)
+				{
+					const Element* pElement = YJ_CONTAINER_OF(p, Element, entry);
+					payload.resize(sizeof(size_t) + pElement->name.size());
+					memcpy(payload.data(), &pElement->v, sizeof(size_t));
+					memcpy(
+							payload.data() + sizeof(size_t), pElement->name.data(), pElement->name.size());
+				});
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		if (!written)
+			throw std::exception("Broken");
+
+		RTable loaded;
+		std::vector<std::unique_ptr<Element>> loadedElements{ size };
+		bool ok = rTableLoad(
+				loaded,
+				path.c_str(),
+				[&](const void* pPayload, size_t payloadSize)
+				{
+					size_t v;
+					memcpy(&v, pPayload, sizeof(size_t));
+					auto pElement = std::make_unique<Element>();
+					pElement->v = v;
+					pElement->name.assign(
+							(const char*)pPayload + sizeof(size_t), payloadSize - sizeof(size_t));
+					// every v is loaded once, each slot is written by one thread only
+					loadedElements[v] = std::move(pElement);
+					return &loadedElements[v]->entry;
+				},
+				RTableConfig{},
+				4);
+		std::filesystem::remove(path);
+		if (!ok || loaded.core.size.load() != size ||
+				loaded.core.pBucketsInfo.load()->nrBucketsPowerOf2 !=
+						tbl.core.pBucketsInfo.load()->nrBucketsPowerOf2)
+			throw std::exception("Broken");
+		RTableReadLockGuard l(loaded);
+		for (size_t i = 0; i < size; ++i)
+		{
+			RNode* pFound = rTableFind(
+					loaded,
+					std::hash<size_t>{}(i),
+					[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; });
+			if (!pFound || YJ_CONTAINER_OF(pFound, Element, entry)->name != elements[i].name)
+				throw std::exception("Broken");
+		}
+
+		// the records of a mixHash table hold mixed hashes, the loaded table mixes the lookups too
+		RTable mixed;
+		RTableConfig mixedConf;
+		mixedConf.mixHash = true;
+		rTableInitDetailed(mixed, mixedConf);
+		const size_t mixedSize = 1000;
+		std::vector<Element> mixedElements{ mixedSize };
+		for (size_t i = 0; i < mixedSize; ++i)
+		{
+			mixedElements[i].v = i;
+			rTableTryInsert(mixed, &mixedElements[i].entry, std::hash<size_t>{}(i), equal);
+		}
+		written = rTableSnapshot(
+				mixed,
+				path.c_str(),
+				[](const RNode* p, std::vector<char>& payload)
+				{
+					payload.resize(sizeof(size_t));
+					memcpy(payload.data(), &YJ_CONTAINER_OF(p, Element, entry)->v, sizeof(size_t));
+				});
+		RTable loadedMixed;
+		std::vector<Element> loadedMixedElements{ mixedSize };
+		ok = rTableLoad(
+				loadedMixed,
+				path.c_str(),
+				[&](const void* pPayload, size_t)
+				{
+					size_t v;
+					memcpy(&v, pPayload, sizeof(size_t));
+					loadedMixedElements[v].v = v;
+					return &loadedMixedElements[v].entry;
+				},
+				RTableConfig{},
+				2);
+		std::filesystem::remove(path);
+		if (!written || !ok || !loadedMixed.core.mixHash)
+			throw std::exception("Broken");
+		{
+			RTableReadLockGuard lMixed(loadedMixed);
+			for (size_t i = 0; i < mixedSize; ++i)
+				if (rTableFind(
+								loadedMixed,
+								std::hash<size_t>{}(i),
+								[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; }) !=
+						&loadedMixedElements[i].entry)
+					throw std::exception("Broken");
+		}
+
+		// crafted files are rejected without calling deserializeFn
+		auto loadCrafted = [&path](const std::vector<uint64_t>& words)
+		{
+			FILE* pFile = fopen(path.c_str(), "wb");
+			fwrite(words.data(), sizeof(uint64_t), words.size(), pFile);
+			fclose(pFile);
+			RTable crafted;
+			bool called = false;
+			bool loaded = rTableLoad(
+					crafted,
+					path.c_str(),
+					[&called](const void*, size_t) -> RNode*
+					{
+						called = true;
+						return nullptr;
+					},
+					RTableConfig{},
+					1);
+			std::filesystem::remove(path);
+			return loaded || called;
+		};
+		// header (magic, nrBuckets, nrNodes, chunkIndexOffset, nrChunks, mixHash), one record (hash,
+		// payloadSize, payload), chunk index
+		const uint64_t magic = c_rTableSnapshotMagic;
+		// a payloadSize that wraps when padded to 8 bytes
+		if (loadCrafted({ magic, 64, 1, 72, 1, 0, 0, ~uint64_t(0) - 3, 0, 48 }))
+			throw std::exception("Broken");
+		// a chunk offset that is not 8 byte aligned
+		if (loadCrafted({ magic, 64, 1, 72, 1, 0, 0, 0, 0, 52 }))
+			throw std::exception("Broken");
+		// a bucket count that does not fit RTableConfig::nrBuckets
+		if (loadCrafted({ magic, uint64_t(1) << 31, 0, 48, 0, 0 }))
+			throw std::exception("Broken");
+		// a record of chunk 1's first bucket in chunk 0
+		const uint64_t chunkBuckets = c_rTableSnapshotChunkBuckets;
+		if (loadCrafted({ magic, 2 * chunkBuckets, 1, 72, 2, 0, chunkBuckets, 8, 0, 48, 72 }))
+			throw std::exception("Broken");
+		// a mixHash flag other than 0 or 1
+		if (loadCrafted({ magic, 64, 0, 48, 0, 2 }))
+			throw std::exception("Broken");
+	}
+
+	// bulk insert into an empty table (one publish) and then into the filled table while a reader
+	// runs, with duplicates inside the batch and against the table
+	void RCUTableBulkInsertTest()
+	{
+		struct Element
+		{
+			size_t v;
+			RNode entry;
+		};
+		auto equal = [](RNode* p1, RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->v == YJ_CONTAINER_OF(p2, Element, entry)->v;
+		};
+		auto find = [](RTable& tbl, size_t v)
+		{
+			return rTableFind(
+					tbl,
+					std::hash<size_t>{}(v),
+					[v](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == v; });
+		};
+		auto nodesOf = [](std::vector<Element>& elements)
+		{
+			std::vector<RNode*> nodes;
+			for (auto& element : elements)
+				nodes.push_back(&element.entry);
+			return nodes;
+		};
+		auto hashesOf = [](const std::vector<Element>& elements)
+		{
+			std::vector<size_t> hashes;
+			for (auto& element : elements)
+				hashes.push_back(std::hash<size_t>{}(element.v));
+			return hashes;
+		};
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t size = 40000;
+		// [0, size) once and every 7th value twice
+		std::vector<Element> elements{ size + (size + 6) / 7 };
+		for (size_t i = 0; i < elements.size(); ++i)
+			elements[i].v = i < size ? i : (i - size) * 7;
+		std::vector<RNode*> nodes = nodesOf(elements);
+		std::vector<size_t> hashes = hashesOf(elements);
+		size_t nrInserted = rTableBulkInsert(
+				tbl,
+				nodes.data(),
+				hashes.data(),
+				nodes.size(),
+				RTableBulkDupPolicy::SkipDuplicates,
+				equal,
+				4);
+		if (nrInserted != size || tbl.core.size.load() != size ||
+				float(size) > tbl.core.expandFactor * tbl.core.pBucketsInfo.load()->nrBucketsPowerOf2)
+			throw std::exception("Broken");
+		// the rejected ones are exactly the second copies, the hashes move with their nodes
+		for (size_t i = size; i < nodes.size(); ++i)
+			if (nodes[i] != &elements[size + (i - size)].entry)
+				throw std::exception("Broken");
+		for (size_t i = 0; i < nodes.size(); ++i)
+			if (hashes[i] != std::hash<size_t>{}(YJ_CONTAINER_OF(nodes[i], Element, entry)->v))
+				throw std::exception("Broken");
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < size; i += 101)
+				{
+					RTableReadLockGuard l(tbl);
+					if (!find(tbl, i))
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		// [size / 2, 2 * size): the first half already exists
+		std::vector<Element> moreElements{ size + size / 2 };
+		for (size_t i = 0; i < moreElements.size(); ++i)
+			moreElements[i].v = size / 2 + i;
+		std::vector<RNode*> moreNodes = nodesOf(moreElements);
+		std::vector<size_t> moreHashes = hashesOf(moreElements);
+		nrInserted = rTableBulkInsert(
+				tbl,
+				moreNodes.data(),
+				moreHashes.data(),
+				moreNodes.size(),
+				RTableBulkDupPolicy::SkipDuplicates,
+				equal);
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		if (nrInserted != size || tbl.core.size.load() != 2 * size)
+			throw std::exception("Broken");
+		RTableReadLockGuard l(tbl);
+		for (size_t i = 0; i < 2 * size; ++i)
+		{
+			RNode* pFound = find(tbl, i);
+			if (!pFound || YJ_CONTAINER_OF(pFound, Element, entry)->v != i)
+				throw std::exception("Broken");
+		}
+		for (size_t i = 0; i < nrInserted; ++i)
+			if (YJ_CONTAINER_OF(moreNodes[i], Element, entry)->v < size)
+				throw std::exception("Broken");
+
+		// no duplicate checks at all
+		RTable trusted;
+		rTableInit(trusted);
+		std::vector<Element> uniqueElements{ size };
+		for (size_t i = 0; i < size; ++i)
+			uniqueElements[i].v = i;
+		std::vector<RNode*> uniqueNodes = nodesOf(uniqueElements);
+		std::vector<size_t> uniqueHashes = hashesOf(uniqueElements);
+		if (rTableBulkInsert(
+						trusted,
+						uniqueNodes.data(),
+						uniqueHashes.data(),
+						size,
+						RTableBulkDupPolicy::NoDuplicates,
+						equal) != size)
+			throw std::exception("Broken");
+		RTableReadLockGuard lTrusted(trusted);
+		for (size_t i = 0; i < size; ++i)
+			if (!find(trusted, i))
+				throw std::exception("Broken");
+	}
+
+	// erase by predicate, by keys and everything, each with one grace period, while a reader finds
+	// the nodes that stay
+	void RCUTableEraseManyTest()
+	{
+		struct Element
+		{
+			size_t v;
+			RNode entry;
+			bool disposed = false;
+		};
+		auto equal = [](RNode* p1, RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->v == YJ_CONTAINER_OF(p2, Element, entry)->v;
+		};
+		auto dispose = [](RNode* p) { YJ_CONTAINER_OF(p, Element, entry)->disposed = true; };
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t size = 30000;
+		std::vector<Element> elements{ size };
+		for (size_t i = 0; i < size; ++i)
+		{
+			elements[i].v = i;
+			rTableTryInsert(tbl, &elements[i].entry, std::hash<size_t>{}(i), equal);
+		}
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < size; i += 3 * 37)
+				{
+					RTableReadLockGuard l(tbl);
+					RNode* pFound = rTableFind(
+							tbl,
+							std::hash<size_t>{}(i),
+							[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; });
+					if (!pFound || YJ_CONTAINER_OF(pFound, Element, entry)->disposed)
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		size_t nrErased = rTableEraseIf(
+				tbl,
+				[](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v % 3 == 1; },
+				dispose);
+		if (nrErased != size / 3 || tbl.core.size.load() != size - size / 3)
+			throw std::exception("Broken");
+
+		// every v % 3 == 2, and keys that do not exist
+		std::vector<size_t> keys;
+		for (size_t i = 2; i < size + size / 2; i += 3)
+			keys.push_back(i);
+		std::vector<size_t> hashVals;
+		for (size_t key : keys)
+			hashVals.push_back(std::hash<size_t>{}(key));
+		uint64_t generation = tbl.core.generation.load();
+		size_t nrDetached = rTableDetachMany(
+				tbl,
+				hashVals.data(),
+				keys.data(),
+				keys.size(),
+				[](const RNode* p, size_t key) { return YJ_CONTAINER_OF(p, Element, entry)->v == key; },
+				dispose);
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		size_t nrLeft = size / 3;
+		// the whole batch counts as one removal
+		if (tbl.core.generation.load() != generation + 1)
+			throw std::exception("Broken");
+		if (nrDetached != size / 3 || tbl.core.size.load() != nrLeft ||
+				float(nrLeft) < tbl.core.shrinkFactor * tbl.core.pBucketsInfo.load()->nrBucketsPowerOf2)
+			throw std::exception("Broken");
+		for (auto& element : elements)
+			if (element.disposed != (element.v % 3 != 0))
+				throw std::exception("Broken");
+
+		RNode* pDetached = rTableTryDetachNoShrink(
+				tbl,
+				std::hash<size_t>{}(0),
+				[](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == 0; });
+		if (pDetached != &elements[0].entry)
+			throw std::exception("Broken");
+		rTableSynchronize(tbl);
+		if (rTableClear(tbl, dispose) != nrLeft - 1 || tbl.core.size.load() != 0)
+			throw std::exception("Broken");
+		for (size_t i = 1; i < size; ++i)
+			if (!elements[i].disposed)
+				throw std::exception("Broken");
+		RTableReadLockGuard l(tbl);
+		if (rTableFind(
+						tbl,
+						std::hash<size_t>{}(3),
+						[](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == 3; }))
+			throw std::exception("Broken");
+	}
+
+	// readers never miss a key while its node is replaced by newer versions, and the versions they
+	// see never go back
+	void RCUTableReplaceTest()
+	{
+		struct Element
+		{
+			size_t v;
+			size_t version;
+			RNode entry;
+		};
+		auto equal = [](RNode* p1, RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->v == YJ_CONTAINER_OF(p2, Element, entry)->v;
+		};
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t size = 1000;
+		for (size_t i = 0; i < size; ++i)
+			rTableTryInsert(tbl, &(new Element{ i, 0, {} })->entry, std::hash<size_t>{}(i), equal);
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			std::vector<size_t> lastVersions(size, 0);
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < size; ++i)
+				{
+					RTableReadLockGuard l(tbl);
+					RNode* pFound = rTableFind(
+							tbl,
+							std::hash<size_t>{}(i),
+							[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; });
+					if (!pFound)
+						throw std::exception("Broken");
+					size_t version = YJ_CONTAINER_OF(pFound, Element, entry)->version;
+					if (version < lastVersions[i])
+						throw std::exception("Broken");
+					lastVersions[i] = version;
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		std::vector<Element*> retired;
+		const size_t nrVersions = 30;
+		for (size_t version = 1; version <= nrVersions; ++version)
+		{
+			for (size_t i = 0; i < size; ++i)
+			{
+				RNode* pOld = rTableReplace(
+						tbl,
+						std::hash<size_t>{}(i),
+						[i](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == i; },
+						&(new Element{ i, version, {} })->entry);
+				if (!pOld || YJ_CONTAINER_OF(pOld, Element, entry)->version != version - 1)
+					throw std::exception("Broken");
+				retired.push_back(YJ_CONTAINER_OF(pOld, Element, entry));
+			}
+			if (version % 4 == 0)
+				rTableExpandBuckets2x(tbl);
+			rTableSynchronize(tbl);
+			for (Element* pElement : retired)
+				delete pElement;
+			retired.clear();
+		}
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+
+		// nothing to replace, the new node is not inserted
+		Element missing{ size, 0, {} };
+		if (rTableReplace(
+						tbl,
+						std::hash<size_t>{}(size),
+						[](RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == size; },
+						&missing.entry) ||
+				tbl.core.size.load() != size)
+			throw std::exception("Broken");
+		rTableClear(tbl, [](RNode* p) { delete YJ_CONTAINER_OF(p, Element, entry); });
+	}
+
+	// find-or-insert only creates nodes on a miss, upsert replaces or inserts, while a reader finds
+	// the keys that were there from the start
+	void RCUTableFindOrInsertTest()
+	{
+		struct Element
+		{
+			size_t v;
+			size_t version;
+			RNode entry;
+		};
+		auto matchOf = [](size_t v)
+		{ return [v](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->v == v; }; };
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t size = 20000;
+		size_t nrCreated = 0;
+		for (size_t i = 0; i < size; i += 2)
+		{
+			bool inserted = false;
+			rTableFindOrInsert(
+					tbl,
+					std::hash<size_t>{}(i),
+					matchOf(i),
+					[&]()
+					{
+						++nrCreated;
+						return &(new Element{ i, 0, {} })->entry;
+					},
+					&inserted);
+			if (!inserted)
+				throw std::exception("Broken");
+		}
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < size; i += 2 * 37)
+				{
+					RTableReadLockGuard l(tbl);
+					if (!rTableFind(tbl, std::hash<size_t>{}(i), matchOf(i)))
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		// the even ones are hits, the odd ones get inserted
+		for (size_t i = 0; i < size; ++i)
+		{
+			bool inserted = true;
+			RNode* pNode = rTableFindOrInsert(
+					tbl,
+					std::hash<size_t>{}(i),
+					matchOf(i),
+					[&]()
+					{
+						++nrCreated;
+						return &(new Element{ i, 0, {} })->entry;
+					},
+					&inserted);
+			if (inserted != (i % 2 == 1) || YJ_CONTAINER_OF(pNode, Element, entry)->v != i)
+				throw std::exception("Broken");
+		}
+		if (nrCreated != size || tbl.core.size.load() != size)
+			throw std::exception("Broken");
+
+		// replace every existing key with version 1, insert [size, 2 * size)
+		std::vector<Element*> retired;
+		for (size_t i = 0; i < 2 * size; ++i)
+		{
+			RNode* pOld =
+					rTableUpsert(tbl, &(new Element{ i, 1, {} })->entry, std::hash<size_t>{}(i), matchOf(i));
+			if ((pOld != nullptr) != (i < size))
+				throw std::exception("Broken");
+			if (pOld)
+				retired.push_back(YJ_CONTAINER_OF(pOld, Element, entry));
+		}
+		rTableSynchronize(tbl);
+		for (Element* pElement : retired)
+			delete pElement;
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		if (tbl.core.size.load() != 2 * size)
+			throw std::exception("Broken");
+		{
+			RTableReadLockGuard l(tbl);
+			for (size_t i = 0; i < 2 * size; ++i)
+			{
+				RNode* pFound = rTableFind(tbl, std::hash<size_t>{}(i), matchOf(i));
+				if (!pFound || YJ_CONTAINER_OF(pFound, Element, entry)->version != 1)
+					throw std::exception("Broken");
+			}
+		}
+		rTableClear(tbl, [](RNode* p) { delete YJ_CONTAINER_OF(p, Element, entry); });
+	}
+
+	// multimap: every key has (key % 5 + 1) values, readers count them with one run while the
+	// table expands and shrinks
+	void RCUTableMultiMapTest()
+	{
+		struct Element
+		{
+			size_t key;
+			size_t value;
+			RNode entry;
+		};
+		auto keyOf = [](size_t key)
+		{ return [key](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->key == key; }; };
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t nrKeys = 2000;
+		std::vector<std::unique_ptr<Element>> elements;
+		// interleave the keys so that the values of a key are not inserted one after another
+		for (size_t iValue = 0; iValue < 5; ++iValue)
+			for (size_t key = 0; key < nrKeys; ++key)
+				if (iValue <= key % 5)
+				{
+					elements.push_back(std::unique_ptr<Element>(new Element{ key, iValue, {} }));
+					rTableInsertMulti(tbl, &elements.back()->entry, std::hash<size_t>{}(key), keyOf(key));
+				}
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t key = 0; key < nrKeys; key += 7)
+				{
+					RTableReadLockGuard l(tbl);
+					size_t valueMask = 0;
+					size_t nrFound = rTableFindAll(
+							tbl,
+							std::hash<size_t>{}(key),
+							keyOf(key),
+							[&](RNode* p)
+							{ valueMask |= size_t(1) << YJ_CONTAINER_OF(p, Element, entry)->value; });
+					if (nrFound != key % 5 + 1 || valueMask != (size_t(1) << nrFound) - 1)
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		for (int i = 0; i < 4; ++i)
+			rTableExpandBuckets2x(tbl);
+		for (int i = 0; i < 6; ++i)
+			rTableShrinkBuckets2x(tbl);
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+
+		// erase one value of each key with several ones
+		for (size_t key = 0; key < nrKeys; ++key)
+			if (key % 5 > 0)
+			{
+				RNode* p = rTableTryDetachAndSynchronize(
+						tbl,
+						std::hash<size_t>{}(key),
+						[key](const RNode* p)
+						{
+							const Element* pElement = YJ_CONTAINER_OF(p, Element, entry);
+							return pElement->key == key && pElement->value == 0;
+						});
+				if (p == nullptr)
+					throw std::exception("Broken");
+			}
+		RTableReadLockGuard l(tbl);
+		for (size_t key = 0; key < nrKeys; ++key)
+			if (rTableFindAll(tbl, std::hash<size_t>{}(key), keyOf(key), [](RNode*) {}) !=
+					(key % 5 > 0 ? key % 5 : 1))
+				throw std::exception("Broken");
+	}
+
+	void RCUTableHashersTest()
+	{
+		std::vector<std::string> strs;
+		for (size_t len = 0; len < 100; ++len)
+			strs.push_back(std::string(len, 'a') + std::to_string(len * 7));
+		std::vector<const void*> ptrs;
+		std::vector<size_t> lens;
+		for (auto& str : strs)
+		{
+			ptrs.push_back(str.data());
+			lens.push_back(str.size());
+		}
+		std::vector<uint64_t> batchHashes(strs.size());
+		rHashBytesBatch(ptrs.data(), lens.data(), strs.size(), batchHashes.data());
+		std::unordered_set<uint64_t> distinctHashes;
+		for (size_t i = 0; i < strs.size(); ++i)
+		{
+			uint64_t h = rHashBytes(strs[i].data(), strs[i].size());
+			if (h != batchHashes[i] || h != RBytesHash{}(strs[i]))
+				throw std::exception("Broken");
+			distinctHashes.insert(h);
+		}
+		if (distinctHashes.size() != strs.size())
+			throw std::exception("Broken");
+		if (rHashBytes("abc", 3, 1) == rHashBytes("abc", 3, 2))
+			throw std::exception("Broken");
+
+		// strided keys hit a single bucket with an identity hash, unless the table mixes it
+		struct Element
+		{
+			size_t key;
+			RNode entry;
+		};
+		auto keyOf = [](size_t key)
+		{ return [key](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->key == key; }; };
+		auto sameKey = [](const RNode* p1, const RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->key ==
+						 YJ_CONTAINER_OF(p2, Element, entry)->key;
+		};
+		auto longestChain = [](RTable& tbl)
+		{
+			size_t longest = 0;
+			RTableCore::BucketsInfo* pInfo = tbl.core.pBucketsInfo.load(std::memory_order_acquire);
+			for (size_t iBucket = 0; iBucket < pInfo->nrBucketsPowerOf2; ++iBucket)
+			{
+				size_t length = 0;
+				for (RcuSlistHead* p = pInfo->pBuckets[iBucket].list.head.next.load();
+						 p != nullptr;
+						 p = p->next.load())
+					++length;
+				longest = std::max(longest, length);
+			}
+			return longest;
+		};
+		RTable tbl;
+		RTableConfig conf;
+		conf.nrBuckets = 1024;
+		conf.mixHash = true;
+		rTableInitDetailed(tbl, conf);
+		const size_t nrKeys = 1000;
+		std::vector<Element> elements{ nrKeys };
+		for (size_t i = 0; i < nrKeys; ++i)
+		{
+			elements[i].key = i * 1024;
+			if (!rTableTryInsert(tbl, &elements[i].entry, std::hash<size_t>{}(i * 1024), sameKey))
+				throw std::exception("Broken");
+		}
+		if (longestChain(tbl) > 10)
+			throw std::exception("Broken");
+
+		auto checkAll = [&](size_t nrPresent)
+		{
+			RTableReadLockGuard l(tbl);
+			for (size_t i = 0; i < nrKeys; ++i)
+			{
+				RNode* p = rTableFind(tbl, std::hash<size_t>{}(i * 1024), keyOf(i * 1024));
+				if ((p != nullptr) != (i < nrPresent))
+					throw std::exception("Broken");
+			}
+		};
+		checkAll(nrKeys);
+		rTableExpandBuckets2x(tbl);
+		checkAll(nrKeys);
+		for (size_t i = nrKeys / 2; i < nrKeys; ++i)
+			if (!rTableTryDetachAndSynchronize(tbl, std::hash<size_t>{}(i * 1024), keyOf(i * 1024)))
+				throw std::exception("Broken");
+		while (rTableShrinkBuckets2x(tbl))
+			;
+		checkAll(nrKeys / 2);
+		if (rTableTryInsert(tbl, &elements[0].entry, std::hash<size_t>{}(0), sameKey))
+			throw std::exception("Broken");
+		// a detached node keeps its stored (mixed) hash, and is reinserted by it
+		for (size_t i = nrKeys / 2; i < nrKeys; ++i)
+			rTableInsertNoExpand(tbl, &elements[i].entry);
+		checkAll(nrKeys);
+
+		// a bulk insert leaves the nodes it rejects untouched, they can be inserted again later
+		RTable bulk;
+		rTableInitDetailed(bulk, conf);
+		// every key twice
+		std::vector<Element> bulkElements{ 2 * nrKeys };
+		std::vector<RNode*> nodes;
+		std::vector<size_t> hashes;
+		for (size_t i = 0; i < 2 * nrKeys; ++i)
+		{
+			bulkElements[i].key = i % nrKeys * 1024;
+			bulkElements[i].entry.hash = 7;
+			nodes.push_back(&bulkElements[i].entry);
+			hashes.push_back(std::hash<size_t>{}(bulkElements[i].key));
+		}
+		if (rTableBulkInsert(
+						bulk,
+						nodes.data(),
+						hashes.data(),
+						nodes.size(),
+						RTableBulkDupPolicy::SkipDuplicates,
+						sameKey) != nrKeys)
+			throw std::exception("Broken");
+		for (size_t i = nrKeys; i < 2 * nrKeys; ++i)
+			if (nodes[i]->hash != 7)
+				throw std::exception("Broken");
+		rTableClear(bulk, [](RNode*) {});
+		if (rTableBulkInsert(
+						bulk,
+						nodes.data() + nrKeys,
+						hashes.data() + nrKeys,
+						nrKeys,
+						RTableBulkDupPolicy::SkipDuplicates,
+						sameKey) != nrKeys)
+			throw std::exception("Broken");
+		RTableReadLockGuard l(bulk);
+		for (size_t i = nrKeys; i < 2 * nrKeys; ++i)
+			if (rTableFind(bulk, hashes[i], keyOf(YJ_CONTAINER_OF(nodes[i], Element, entry)->key)) !=
+					nodes[i])
+				throw std::exception("Broken");
+	}
+
+	void RCUTableStatsTest()
+	{
+		struct Element
+		{
+			size_t key;
+			RNode entry;
+		};
+		auto sameKey = [](const RNode* p1, const RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->key ==
+						 YJ_CONTAINER_OF(p2, Element, entry)->key;
+		};
+		RTable tbl;
+		rTableInit(tbl, 64);
+		const size_t nrKeys = 5000;
+		std::vector<Element> elements{ nrKeys };
+		for (size_t i = 0; i < nrKeys; ++i)
+		{
+			elements[i].key = i;
+			rTableTryInsert(tbl, &elements[i].entry, std::hash<size_t>{}(i), sameKey);
+		}
+
+		RTableStats stats = rTableGetStats(tbl);
+		size_t nrBucketsInHistogram = 0;
+		for (size_t n : stats.chainLengthHistogram)
+			nrBucketsInHistogram += n;
+		if (stats.size != nrKeys || stats.nrVisitedBuckets != stats.nrBuckets ||
+				nrBucketsInHistogram != stats.nrBuckets || stats.maxChainLength == 0 ||
+				stats.avgChainLength * stats.nrBuckets + 0.5f < float(nrKeys) ||
+				stats.avgChainLength * stats.nrBuckets - 0.5f > float(nrKeys))
+			throw std::exception("Broken");
+		if (stats.nrExpands == 0 || stats.nrExpandGracePeriods < stats.nrExpands ||
+				stats.expandNanos == 0 || stats.nrShrinks != 0)
+			throw std::exception("Broken");
+
+		RTableStats sampled = rTableGetStats(tbl, 16);
+		if (sampled.nrVisitedBuckets != 16 || sampled.nrBuckets != stats.nrBuckets)
+			throw std::exception("Broken");
+
+		for (size_t i = 0; i < nrKeys - 100; ++i)
+			rTableTryDetachAndSynchronize(
+					tbl,
+					std::hash<size_t>{}(i),
+					[i](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->key == i; });
+		stats = rTableGetStats(tbl);
+		if (stats.size != 100 || stats.nrShrinks == 0 || stats.shrinkNanos == 0)
+			throw std::exception("Broken");
+	}
+
+	void RCUTableBloomTest()
+	{
+		struct Element
+		{
+			size_t key;
+			RNode entry;
+		};
+		auto sameKey = [](const RNode* p1, const RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->key ==
+						 YJ_CONTAINER_OF(p2, Element, entry)->key;
+		};
+		auto keyOf = [](size_t key)
+		{ return [key](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->key == key; }; };
+		RTable tbl;
+		RTableConfig conf;
+		conf.nrBuckets = 16;
+		conf.bloomBitsPerElement = 16;
+		rTableInitDetailed(tbl, conf);
+		// the even keys below nrStable stay in the table for the whole test
+		const size_t nrStable = 1000;
+		const size_t nrKeys = 8000;
+		std::vector<Element> elements{ nrKeys };
+		for (size_t key = 0; key < nrStable; key += 2)
+		{
+			elements[key].key = key;
+			rTableTryInsert(tbl, &elements[key].entry, std::hash<size_t>{}(key), sameKey);
+		}
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t key = 0; key < nrStable; ++key)
+				{
+					RTableReadLockGuard l(tbl);
+					RNode* p = rTableFind(tbl, std::hash<size_t>{}(key), keyOf(key));
+					if ((p != nullptr) != (key % 2 == 0))
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		// the filter is rebuilt with each expand, shrink and after enough erases
+		for (int round = 0; round < 2; ++round)
+		{
+			for (size_t key = nrStable; key < nrKeys; key += 2)
+			{
+				elements[key].key = key;
+				rTableTryInsert(tbl, &elements[key].entry, std::hash<size_t>{}(key), sameKey);
+			}
+			for (size_t key = nrStable; key < nrKeys; key += 2)
+				if (!rTableTryDetachAndSynchronize(tbl, std::hash<size_t>{}(key), keyOf(key)))
+					throw std::exception("Broken");
+		}
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+
+		// churn at a constant size: without rebuilds the stale bits would pile up
+		for (size_t key = nrStable; key < nrKeys; key += 2)
+		{
+			rTableTryInsert(tbl, &elements[key].entry, std::hash<size_t>{}(key), sameKey);
+			if (!rTableTryDetachAndSynchronize(tbl, std::hash<size_t>{}(key), keyOf(key)))
+				throw std::exception("Broken");
+		}
+		RTableBloom* pBloom = tbl.core.pBloom.load();
+		if (pBloom->nrRemoved.load() > pBloom->capacity)
+			throw std::exception("Broken");
+
+		// few of the absent keys get past the filter
+		size_t nrPassed = 0;
+		for (size_t key = 1; key < nrKeys; key += 2)
+			if (rTableCoreDetail::bloomMayContain(tbl.core, std::hash<size_t>{}(key)))
+				++nrPassed;
+		if (nrPassed > nrKeys / 2 / 20)
+			throw std::exception("Broken");
+
+		std::vector<size_t> hashes(nrStable);
+		std::vector<size_t> keys(nrStable);
+		std::vector<RNode*> found(nrStable);
+		for (size_t key = 0; key < nrStable; ++key)
+		{
+			keys[key] = key;
+			hashes[key] = std::hash<size_t>{}(key);
+		}
+		{
+			RTableReadLockGuard l(tbl);
+			rTableFindBatch(
+					tbl,
+					hashes.data(),
+					keys.data(),
+					found.data(),
+					nrStable,
+					[](const RNode* p, size_t key)
+					{ return YJ_CONTAINER_OF(p, Element, entry)->key == key; });
+		}
+		for (size_t key = 0; key < nrStable; ++key)
+			if ((found[key] != nullptr) != (key % 2 == 0))
+				throw std::exception("Broken");
+
+		rTableClear(tbl, [](RNode*) {});
+		for (size_t key = 0; key < nrStable; key += 2)
+			if (rTableCoreDetail::bloomMayContain(tbl.core, std::hash<size_t>{}(key)))
+				throw std::exception("Broken");
+	}
+
+	void RCompactTableTest()
+	{
+		struct Element
+		{
+			size_t key;
+			RCompactNode node;
+		};
+		static_assert(sizeof(RCompactNode) == 8);
+		const uint32_t nrElements = 6000;
+		// even keys below nrStable stay in the table, the others come and go
+		const uint32_t nrStable = 2000;
+		std::vector<Element> arena{ nrElements };
+		RCompactTable tbl;
+		rCompactTableInit(tbl, arena.data(), sizeof(Element), offsetof(Element, node), 16);
+		auto keyOf = [&arena](size_t key)
+		{ return [&arena, key](uint32_t index) { return arena[index].key == key; }; };
+		for (uint32_t i = 0; i < nrElements; ++i)
+			arena[i].key = i;
+		for (uint32_t i = 0; i < nrStable; i += 2)
+			if (!rCompactTableTryInsert(tbl, i, RIntHash{}(i), keyOf(i)))
+				throw std::exception("Broken");
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (uint32_t i = 0; i < nrStable; ++i)
+				{
+					RCompactTableReadLockGuard l(tbl);
+					uint32_t index = rCompactTableFind(tbl, RIntHash{}(i), keyOf(i));
+					if ((index != c_rCompactNull) != (i % 2 == 0) ||
+							(index != c_rCompactNull && index != i))
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		for (int round = 0; round < 2; ++round)
+		{
+			for (uint32_t i = nrStable; i < nrElements; ++i)
+				if (!rCompactTableTryInsert(tbl, i, RIntHash{}(i), keyOf(i)))
+					throw std::exception("Broken");
+			if (rCompactTableTryInsert(tbl, nrStable, RIntHash{}(nrStable), keyOf(nrStable)))
+				throw std::exception("Broken");
+			size_t nrBucketsFull = tbl.pBucketsInfo.load()->nrBucketsPowerOf2;
+			// shrinks on the way
+			for (uint32_t i = nrStable; i < nrElements; ++i)
+				if (rCompactTableTryDetachAndSynchronize(tbl, RIntHash{}(i), keyOf(i)) != i)
+					throw std::exception("Broken");
+			if (tbl.pBucketsInfo.load()->nrBucketsPowerOf2 >= nrBucketsFull)
+				throw std::exception("Broken");
+		}
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		if (rCompactTableSize(tbl) != nrStable / 2)
+			throw std::exception("Broken");
+	}
+
+	void RCUTableHandleTest()
+	{
+		struct Element
+		{
+			size_t key;
+			RHandleNode handle;
+		};
+		auto sameKey = [](const RNode* p1, const RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, handle.node)->key ==
+						 YJ_CONTAINER_OF(p2, Element, handle.node)->key;
+		};
+		auto keyOf = [](size_t key)
+		{
+			return [key](const RNode* p)
+			{ return YJ_CONTAINER_OF(p, Element, handle.node)->key == key; };
+		};
+		RTable tbl;
+		RTableConfig conf;
+		conf.nrBuckets = 16;
+		conf.handleNodes = true;
+		rTableInitDetailed(tbl, conf);
+		// the even keys below nrStable stay in the table for the whole test
+		const size_t nrStable = 1000;
+		const size_t nrKeys = 6000;
+		std::vector<Element> elements{ nrKeys };
+		for (size_t key = 0; key < nrKeys; ++key)
+			elements[key].key = key;
+		for (size_t key = 0; key < nrStable; key += 2)
+			rTableHandleTryInsert(tbl, &elements[key].handle, std::hash<size_t>{}(key), sameKey);
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t key = 0; key < nrStable; ++key)
+				{
+					RTableReadLockGuard l(tbl);
+					RNode* p = rTableFind(tbl, std::hash<size_t>{}(key), keyOf(key));
+					if ((p != nullptr) != (key % 2 == 0))
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		std::mt19937 rng(7);
+		for (int round = 0; round < 2; ++round)
+		{
+			// grows through expands, which relink the back pointers
+			for (size_t key = nrStable; key < nrKeys; ++key)
+				if (!rTableHandleTryInsert(tbl, &elements[key].handle, std::hash<size_t>{}(key), sameKey))
+					throw std::exception("Broken");
+			if (rTableHandleTryInsert(tbl, &elements[0].handle, std::hash<size_t>{}(0), sameKey))
+				throw std::exception("Broken");
+			// unlink by handle in random order, heads, middles and tails of the chains
+			std::vector<size_t> order;
+			for (size_t key = nrStable; key < nrKeys; ++key)
+				order.push_back(key);
+			std::shuffle(order.begin(), order.end(), rng);
+			for (size_t i = 0; i < order.size(); ++i)
+				if (i % 16 == 0)
+					rTableDetachNodeAndSynchronize(tbl, &elements[order[i]].handle);
+				else
+					rTableDetachNode(tbl, &elements[order[i]].handle);
+			rTableSynchronize(tbl);
+			if (rTableShrinkBuckets2x(tbl))
+				rTableExpandBuckets2x(tbl);
+		}
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		RTableReadLockGuard l(tbl);
+		for (size_t key = 0; key < nrKeys; ++key)
+			if ((rTableFind(tbl, std::hash<size_t>{}(key), keyOf(key)) != nullptr) !=
+					(key < nrStable && key % 2 == 0))
+				throw std::exception("Broken");
+		if (tbl.core.size.load() != nrStable / 2)
+			throw std::exception("Broken");
+
+		// a loaded table gets its back pointers too
+		std::string path =
+				(std::filesystem::temp_directory_path() / "rtable_handle_test.bin").string();
+		bool written = rTableCoreSnapshot(
+				tbl.core,
+				path.c_str(),
+				[](const RNode* p, std::vector<char>& payload)
+				{
+					size_t key = YJ_CONTAINER_OF(p, Element, handle.node)->key;
+					payload.resize(sizeof(key));
+					memcpy(payload.data(), &key, sizeof(key));
+				});
+		RTable loaded;
+		std::vector<Element> loadedElements{ nrStable };
+		bool ok = rTableLoad(
+				loaded,
+				path.c_str(),
+				[&](const void* pPayload, size_t)
+				{
+					size_t key;
+					memcpy(&key, pPayload, sizeof(key));
+					loadedElements[key].key = key;
+					return &loadedElements[key].handle.node;
+				},
+				conf,
+				2);
+		std::filesystem::remove(path);
+		if (!written || !ok || loaded.core.size.load() != nrStable / 2)
+			throw std::exception("Broken");
+		for (size_t key = 0; key < nrStable; key += 2)
+			rTableDetachNode(loaded, &loadedElements[key].handle);
+		rTableSynchronize(loaded);
+		if (loaded.core.size.load() != 0 ||
+				rTableFind(loaded, std::hash<size_t>{}(0), keyOf(0)) != nullptr)
+			throw std::exception("Broken");
+	}
+
+	void RCUTableHotCacheTest()
+	{
+		struct Element
+		{
+			size_t key;
+			size_t value;
+			RNode entry;
+		};
+		auto sameKey = [](const RNode* p1, const RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, entry)->key ==
+						 YJ_CONTAINER_OF(p2, Element, entry)->key;
+		};
+		auto keyOf = [](size_t key)
+		{ return [key](const RNode* p) { return YJ_CONTAINER_OF(p, Element, entry)->key == key; }; };
+		RTable tbl;
+		rTableInit(tbl);
+		const size_t nrStable = 100;
+		const size_t nrChurned = 100;
+		std::vector<Element> stableElements{ nrStable };
+		for (size_t key = 0; key < nrStable; ++key)
+		{
+			stableElements[key].key = key;
+			rTableTryInsert(tbl, &stableElements[key].entry, std::hash<size_t>{}(key), sameKey);
+		}
+
+		thread_local RTableHotCache cache;
+		{
+			RTableReadLockGuard l(tbl);
+			for (int pass = 0; pass < 2; ++pass)
+				for (size_t key = 0; key < nrStable; ++key)
+					if (rTableCachedFind(tbl, cache, std::hash<size_t>{}(key), keyOf(key)) !=
+							&stableElements[key].entry)
+						throw std::exception("Broken");
+		}
+		// a replaced node is not returned from the cache anymore
+		Element replacement{ 7, 1, {} };
+		RNode* pOld = rTableReplace(tbl, std::hash<size_t>{}(7), keyOf(7), &replacement.entry);
+		rTableSynchronize(tbl);
+		{
+			RTableReadLockGuard l(tbl);
+			if (rTableCachedFind(tbl, cache, std::hash<size_t>{}(7), keyOf(7)) != &replacement.entry)
+				throw std::exception("Broken");
+		}
+		rTableReplace(tbl, std::hash<size_t>{}(7), keyOf(7), pOld);
+		rTableSynchronize(tbl);
+		// nor a detached one
+		Element* pDetached = new Element{ nrStable, nrStable * 2, {} };
+		rTableTryInsert(tbl, &pDetached->entry, std::hash<size_t>{}(nrStable), sameKey);
+		{
+			RTableReadLockGuard l(tbl);
+			if (rTableCachedFind(tbl, cache, std::hash<size_t>{}(nrStable), keyOf(nrStable)) !=
+					&pDetached->entry)
+				throw std::exception("Broken");
+		}
+		rTableTryDetachAndSynchronize(tbl, std::hash<size_t>{}(nrStable), keyOf(nrStable));
+		delete pDetached;
+		{
+			RTableReadLockGuard l(tbl);
+			if (rTableCachedFind(tbl, cache, std::hash<size_t>{}(nrStable), keyOf(nrStable)))
+				throw std::exception("Broken");
+		}
+		// nor one of a previous table at the same address, both start at the same generation
+		{
+			std::optional<RTable> rebuilt;
+			Element element{ 0, 0, {} };
+			for (int round = 0; round < 2; ++round)
+			{
+				rebuilt.emplace();
+				rTableInit(*rebuilt);
+				if (round == 0)
+					rTableTryInsert(*rebuilt, &element.entry, std::hash<size_t>{}(0), sameKey);
+				RTableReadLockGuard l(*rebuilt);
+				RNode* p = rTableCachedFind(*rebuilt, cache, std::hash<size_t>{}(0), keyOf(0));
+				if (p != (round == 0 ? &element.entry : nullptr))
+					throw std::exception("Broken");
+			}
+		}
+
+		// the churned keys are detached and freed all the time, a stale hit would read freed memory
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t key = 0; key < nrStable + nrChurned; ++key)
+				{
+					RTableReadLockGuard l(tbl);
+					RNode* p = rTableCachedFind(tbl, cache, std::hash<size_t>{}(key), keyOf(key));
+					if (key < nrStable && p != &stableElements[key].entry)
+						throw std::exception("Broken");
+					if (p && YJ_CONTAINER_OF(p, Element, entry)->value != key * 2)
+						throw std::exception("Broken");
+				}
+		};
+		for (auto& element : stableElements)
+			element.value = element.key * 2;
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		for (int round = 0; round < 20; ++round)
+			for (size_t key = nrStable; key < nrStable + nrChurned; ++key)
+			{
+				Element* pElement = new Element{ key, key * 2, {} };
+				if (!rTableTryInsert(tbl, &pElement->entry, std::hash<size_t>{}(key), sameKey))
+					delete pElement;
+				if (key % 3 == 0)
+				{
+					RNode* p = rTableTryDetachAndSynchronize(tbl, std::hash<size_t>{}(key), keyOf(key));
+					delete YJ_CONTAINER_OF(p, Element, entry);
+				}
+			}
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		rTableClear(
+				tbl,
+				[nrStable](RNode* p)
+				{
+					Element* pElement = YJ_CONTAINER_OF(p, Element, entry);
+					if (pElement->key >= nrStable)
+						delete pElement;
+				});
+	}
+
+	void RTableCombinerTest()
+	{
+		struct Element
+		{
+			size_t key;
+			size_t value;
+			RNode node;
+		};
+		RTableCombinerMatchFn matchFn = [](const RNode* p, const void* pKey)
+		{ return YJ_CONTAINER_OF(p, Element, node)->key == *static_cast<const size_t*>(pKey); };
+		auto sameKey = [](const RNode* p1, const RNode* p2)
+		{ return YJ_CONTAINER_OF(p1, Element, node)->key == YJ_CONTAINER_OF(p2, Element, node)->key; };
+		auto keyOf = [](size_t key)
+		{
+			return [key](const RNode* p)
+			{ return YJ_CONTAINER_OF(p, Element, node)->key == key; };
+		};
+		{
+			// the operations of one batch apply in the posting order
+			RTable tbl;
+			rTableInit(tbl, 16);
+			RTableCombiner comb;
+			rTableCombinerInit(comb, tbl, matchFn);
+			Element elements[3] = { { 1, 0, {} }, { 1, 1, {} }, { 1, 2, {} } };
+			size_t key1 = 1;
+			size_t key2 = 2;
+			RTableCombinedOp ops[4];
+			ops[0].pNode = &elements[0].node;
+			ops[1].pNode = &elements[1].node;
+			ops[2].type = RTableCombinedOpType::Replace;
+			ops[2].pNode = &elements[2].node;
+			ops[3].type = RTableCombinedOpType::Erase;
+			for (int i = 0; i < 4; ++i)
+			{
+				ops[i].pKey = i == 3 ? &key2 : &key1;
+				ops[i].hashVal = std::hash<size_t>{}(*static_cast<const size_t*>(ops[i].pKey));
+				rTableCombinerPost(comb, ops[i]);
+			}
+			if (!rTableCombinerTryCombine(comb) || rTableCombinerTryCombine(comb))
+				throw std::exception("Broken");
+			for (int i = 0; i < 4; ++i)
+				if (!ops[i].done.load())
+					throw std::exception("Broken");
+			if (ops[0].pResult != &elements[0].node || ops[1].pResult != nullptr ||
+					ops[2].pResult != &elements[0].node || ops[3].pResult != nullptr)
+				throw std::exception("Broken");
+			if (comb.nrBatches.load() != 1 || comb.nrCombinedOps.load() != 4)
+				throw std::exception("Broken");
+			RNode* p = rTableCombinerTryDetachAndSynchronize(comb, std::hash<size_t>{}(1), &key1);
+			if (p != &elements[2].node || tbl.core.size.load() != 0)
+				throw std::exception("Broken");
+		}
+
+		// producers churn their own keys while a reader checks the stable ones
+		RTable tbl;
+		rTableInit(tbl, 16);
+		const size_t nrStable = 500;
+		const size_t nrProducers = 4;
+		const size_t nrKeysPerProducer = 1000;
+		const size_t nrKeys = nrStable + nrProducers * nrKeysPerProducer;
+		std::vector<Element> elements{ nrKeys };
+		std::vector<Element> replacements{ nrKeys };
+		for (size_t key = 0; key < nrKeys; ++key)
+		{
+			elements[key].key = replacements[key].key = key;
+			elements[key].value = 0;
+			replacements[key].value = 1;
+		}
+		for (size_t key = 0; key < nrStable; ++key)
+			rTableTryInsert(tbl, &elements[key].node, std::hash<size_t>{}(key), sameKey);
+		RTableCombiner comb;
+		rTableCombinerInit(comb, tbl, matchFn);
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t key = 0; key < nrStable; ++key)
+				{
+					RTableReadLockGuard l(tbl);
+					if (!rTableFind(tbl, std::hash<size_t>{}(key), keyOf(key)))
+						throw std::exception("Broken");
+				}
+		};
+		auto producer = [&](size_t iProducer)
+		{
+			size_t first = nrStable + iProducer * nrKeysPerProducer;
+			for (size_t key = first; key < first + nrKeysPerProducer; ++key)
+				if (!rTableCombinerTryInsert(comb, &elements[key].node, std::hash<size_t>{}(key), &key))
+					throw std::exception("Broken");
+			for (size_t key = first; key < first + nrKeysPerProducer; ++key)
+				if (key % 2 == 1)
+				{
+					RNode* p = rTableCombinerReplaceAndSynchronize(
+							comb, std::hash<size_t>{}(key), &key, &replacements[key].node);
+					if (p != &elements[key].node)
+						throw std::exception("Broken");
+				}
+				else if (key % 4 == 0)
+				{
+					RNode* p = rTableCombinerTryDetachAndSynchronize(comb, std::hash<size_t>{}(key), &key);
+					if (p != &elements[key].node)
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		std::vector<std::future<void>> producerFutures(nrProducers);
+		for (size_t iProducer = 0; iProducer < nrProducers; ++iProducer)
+			producerFutures[iProducer] = std::async(std::launch::async, producer, iProducer);
+		for (auto& future : producerFutures)
+			future.get();
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+
+		size_t nrExpected = nrStable;
+		RTableReadLockGuard l(tbl);
+		for (size_t key = nrStable; key < nrKeys; ++key)
+		{
+			RNode* p = rTableFind(tbl, std::hash<size_t>{}(key), keyOf(key));
+			if (key % 4 == 0 ? p != nullptr : p == nullptr)
+				throw std::exception("Broken");
+			if (p && YJ_CONTAINER_OF(p, Element, node)->value != key % 2)
+				throw std::exception("Broken");
+			nrExpected += p != nullptr;
+		}
+		if (tbl.core.size.load() != nrExpected)
+			throw std::exception("Broken");
+		if (comb.nrCombinedOps.load() != nrProducers * nrKeysPerProducer * 7 / 4)
+			throw std::exception("Broken");
+	}
+
+	void RCUTableFindBatchTest()
+	{
+		RTable tbl;
+		rTableInit(tbl);
+
+		struct Element
+		{
+			size_t v;
+			RNode entry;
+			static Element* fromNode(const RNode* pEntry)
+			{
+				return YJ_CONTAINER_OF(pEntry, Element, entry);
+			}
+		};
+		std::vector<Element> values{ 10000 };
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			values[i].v = i;
+			bool inserted = rTableTryInsert(
+					tbl,
+					&values[i].entry,
+					std::hash<size_t>{}(i),
+					[](RNode* p0, RNode* p1)
+					{ return Element::fromNode(p0)->v == Element::fromNode(p1)->v; });
+			if (!inserted)
+				throw std::exception("Broken");
+		}
+
+		// odd keys are beyond the inserted range and should not be found,
+		// the batch size is not a multiple of the group size on purpose
+		constexpr size_t c_batchSize = 37;
+		size_t keys[c_batchSize];
+		size_t hashVals[c_batchSize];
+		RNode* pFounds[c_batchSize];
+		for (size_t start = 0; start < values.size(); start += c_batchSize)
+		{
+			for (size_t i = 0; i < c_batchSize; ++i)
+			{
+				keys[i] = i % 2 == 0 ? start + i : start + i + values.size();
+				hashVals[i] = std::hash<size_t>{}(keys[i]);
+			}
+			RTableReadLockGuard l(tbl);
+			rTableFindBatch(
+					tbl,
+					hashVals,
+					keys,
+					pFounds,
+					c_batchSize,
+					[](const RNode* p, size_t key) { return Element::fromNode(p)->v == key; });
+			for (size_t i = 0; i < c_batchSize; ++i)
+			{
+				bool shouldFind = i % 2 == 0 && keys[i] < values.size();
+				if (shouldFind && pFounds[i] != &values[keys[i]].entry)
+					throw std::exception("Broken");
+				if (!shouldFind && pFounds[i])
+					throw std::exception("Broken");
+			}
+		}
+	}
+	// the cache stays within its capacity, keeps the keys that are hit between the sweeps, and
+	// disposes every evicted entry once, while a reader keeps hitting the hot keys
+	void RCacheTest()
+	{
+		struct Element
+		{
+			size_t v;
+			RCacheNode node;
+		};
+		auto equal = [](const RCacheNode* p1, const RCacheNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Element, node)->v == YJ_CONTAINER_OF(p2, Element, node)->v;
+		};
+		auto matchOf = [](size_t v)
+		{ return [v](const RCacheNode* p) { return YJ_CONTAINER_OF(p, Element, node)->v == v; }; };
+		size_t nrDisposed = 0;
+		auto dispose = [&nrDisposed](RCacheNode* p)
+		{
+			++nrDisposed;
+			delete YJ_CONTAINER_OF(p, Element, node);
+		};
+		const size_t capacity = 1000;
+		const size_t nrHot = 100;
+		RCache cache;
+		rCacheInit(cache, capacity);
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < nrHot; ++i)
+				{
+					RCacheReadLockGuard l(cache);
+					RCacheNode* pFound = rCacheFind(cache, std::hash<size_t>{}(i), matchOf(i));
+					if (pFound && YJ_CONTAINER_OF(pFound, Element, node)->v != i)
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+		const size_t nrInserts = 20000;
+		for (size_t i = 0; i < nrInserts; ++i)
+		{
+			if (!rCacheTryInsert(
+							cache, &(new Element{ i, {} })->node, std::hash<size_t>{}(i), equal, dispose))
+				throw std::exception("Broken");
+			if (rCacheSize(cache) > capacity)
+				throw std::exception("Broken");
+			// the hot keys are hit more often than the sweep comes around
+			if (i % 100 == 0)
+			{
+				RCacheReadLockGuard l(cache);
+				for (size_t iHot = 0; iHot < nrHot; ++iHot)
+					rCacheFind(cache, std::hash<size_t>{}(iHot), matchOf(iHot));
+			}
+		}
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		{
+			RCacheReadLockGuard l(cache);
+			for (size_t i = 0; i < nrHot; ++i)
+				if (!rCacheFind(cache, std::hash<size_t>{}(i), matchOf(i)))
+					throw std::exception("Broken");
+		}
+		if (nrDisposed + rCacheSize(cache) != nrInserts)
+			throw std::exception("Broken");
+
+		RCacheNode* pErased =
+				rCacheTryDetachAndSynchronize(cache, std::hash<size_t>{}(0), matchOf(0));
+		if (pErased == nullptr)
+			throw std::exception("Broken");
+		dispose(pErased);
+		rCacheClear(cache, dispose);
+		if (rCacheSize(cache) != 0 || nrDisposed != nrInserts)
+			throw std::exception("Broken");
+
+		// the default batch is larger than this capacity, the inserted node still survives its
+		// insert, even when every other entry is referenced
+		RCache small;
+		rCacheInit(small, 16);
+		nrDisposed = 0;
+		const size_t nrSmallInserts = 100;
+		for (size_t i = 0; i < nrSmallInserts; ++i)
+		{
+			Element* pElement = new Element{ i, {} };
+			if (!rCacheTryInsert(small, &pElement->node, std::hash<size_t>{}(i), equal, dispose) ||
+					rCacheSize(small) > 16)
+				throw std::exception("Broken");
+			RCacheReadLockGuard l(small);
+			if (rCacheFind(small, std::hash<size_t>{}(i), matchOf(i)) != &pElement->node)
+				throw std::exception("Broken");
+			for (size_t iHit = 0; iHit < i; ++iHit)
+				rCacheFind(small, std::hash<size_t>{}(iHit), matchOf(iHit));
+		}
+		rCacheClear(small, dispose);
+		if (nrDisposed != nrSmallInserts)
+			throw std::exception("Broken");
+	}
+
+	void RHashMapTest()
+	{
+		RHashMap<std::string, size_t> map{ 4 };
+		const size_t size = 2000;
+		for (size_t i = 0; i < size; ++i)
+			if (!map.insert(std::to_string(i), i))
+				throw std::exception("Broken");
+		if (map.insert(std::string("7"), size_t(0)) || map.size() != size)
+			throw std::exception("Broken");
+
+		std::atomic<bool> finished = false;
+		auto reader = [&]()
+		{
+			while (!finished.load(std::memory_order_relaxed))
+				for (size_t i = 0; i < size; i += 7)
+				{
+					RHashMap<std::string, size_t>::ReadLockGuard l(map);
+					const size_t* pVal = map.find(std::to_string(i));
+					// only odd keys are erased
+					if (i % 2 == 0 && (!pVal || *pVal != i))
+						throw std::exception("Broken");
+					if (pVal && *pVal != i)
+						throw std::exception("Broken");
+				}
+		};
+		std::future<void> readerFuture = std::async(std::launch::async, reader);
+
+		for (size_t i = 1; i < size; i += 4)
+			if (!map.erase(std::to_string(i)))
+				throw std::exception("Broken");
+		for (size_t i = 3; i < size; i += 4)
+			if (!map.eraseDeferred(std::to_string(i)))
+				throw std::exception("Broken");
+		map.reclaim();
+		if (map.erase(std::to_string(1)) || map.size() != size / 2)
+			throw std::exception("Broken");
+
+		finished.store(true, std::memory_order_relaxed);
+		readerFuture.get();
+		// the remaining nodes are freed by the destructor
+	}
+
+	struct RNodePoolStress
+	{
+		struct Val
+		{
+			RNode entry;
+			size_t v;
+			std::atomic<bool> valid = false;
+		};
+		static constexpr size_t c_size = 4096;
+		static constexpr size_t c_nrRounds = 8;
+
+		void run()
+		{
+			RTable rTable;
+			rTableInit(rTable, 64);
+			RNodePool pool;
+			RNodePoolConfig conf;
+			conf.nodeSize = sizeof(Val);
+			conf.nrSlotsPerSlab = 128;
+			rNodePoolInitDetailed(pool, rTable.rcuZone, conf);
+
+			auto equal = [](RNode* p1, RNode* p2)
+			{ return YJ_CONTAINER_OF(p1, Val, entry)->v == YJ_CONTAINER_OF(p2, Val, entry)->v; };
+			auto insert = [&](size_t i)
+			{
+				Val* pVal = rNodePoolNew<Val>(pool);
+				if ((uintptr_t)pVal % c_rNodePoolSlotAlignment != 0)
+					throw std::exception("Broken");
+				pVal->v = i;
+				pVal->valid = true;
+				if (!rTableTryInsert(rTable, &pVal->entry, std::hash<size_t>{}(i), equal))
+					throw std::exception("Broken");
+			};
+			for (size_t i = 0; i < c_size; ++i)
+				insert(i);
+
+			std::atomic<bool> finished = false;
+			auto reader = [&]()
+			{
+				while (!finished.load(std::memory_order_relaxed))
+					for (size_t i = 0; i < c_size; ++i)
+					{
+						RTableReadLockGuard l(rTable);
+						RNode* pFound = rTableFind(
+								rTable,
+								std::hash<size_t>{}(i),
+								[i](RNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+						// a slot reused too early would be seen invalid or with another value
+						if (i % 2 == 0 && !pFound)
+							throw std::exception("Broken");
+						if (pFound &&
+								(!YJ_CONTAINER_OF(pFound, Val, entry)->valid ||
+								 YJ_CONTAINER_OF(pFound, Val, entry)->v != i))
+							throw std::exception("ElementNotValid in reader critical session.");
+					}
+			};
+			std::future<void> readerFuture = std::async(std::launch::async, reader);
+
+			// odd elements are retired without synchronize and inserted again with recycled slots
+			for (size_t round = 0; round < c_nrRounds; ++round)
+			{
+				for (size_t i = 1; i < c_size; i += 2)
+				{
+					RNode* pDetached = rTableTryDetachAutoShrink(
+							rTable,
+							std::hash<size_t>{}(i),
+							[i](RNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+					if (!pDetached)
+						throw std::exception("Broken");
+					// readers see it valid until the grace period, the slot is not reused before
+					rNodePoolRetire(pool, YJ_CONTAINER_OF(pDetached, Val, entry));
+					if (i % 256 == 1)
+						rTableSynchronize(rTable);
+				}
+				for (size_t i = 1; i < c_size; i += 2)
+					insert(i);
+			}
+			finished.store(true, std::memory_order_relaxed);
+			readerFuture.get();
+
+			// slots are recycled, so the pool does not grow with the rounds
+			size_t nrSlabs = 0;
+			for (size_t iCache = 0; iCache < pool.nrCachesPowerOf2; ++iCache)
+				nrSlabs += pool.pCaches[iCache].slabs.size();
+			if (nrSlabs * conf.nrSlotsPerSlab > c_size * 3)
+				throw std::exception("Broken");
+		}
+	};
+
+	struct RSplitTableStress
+	{
+		struct Val
+		{
+			size_t v;
+			RSplitNode entry;
+			std::atomic<bool> valid = false;
+		};
+		static constexpr size_t c_size = 8888;
+		size_t sizePersist = 888;
+
+		static bool equal(RSplitNode* p1, RSplitNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Val, entry)->v == YJ_CONTAINER_OF(p2, Val, entry)->v;
+		}
+
+		void run()
+		{
+			RSplitTable table;
+			rSplitTableInit(table, 1);
+			std::vector<Val> arr = std::vector<Val>{ c_size };
+			for (size_t i = 0; i < sizePersist; ++i)
+			{
+				arr[i].v = i;
+				arr[i].valid = true;
+				if (!rSplitTableTryInsert(table, &arr[i].entry, std::hash<size_t>{}(i), equal))
+					throw std::exception("Broken");
+			}
+
+			std::atomic<bool> finished = false;
+			auto reader = [&]()
+			{
+				while (!finished.load(std::memory_order_relaxed))
+					for (size_t i = 0; i < c_size; ++i)
+					{
+						RSplitTableReadLockGuard l(table);
+						RSplitNode* pFound = rSplitTableFind(
+								table,
+								std::hash<size_t>{}(i),
+								[i](RSplitNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+						if (i < sizePersist && !pFound)
+							throw std::exception("Broken");
+						if (pFound && !YJ_CONTAINER_OF(pFound, Val, entry)->valid)
+							throw std::exception("ElementNotValid in reader critical session.");
+					}
+			};
+			std::future<void> readers[2];
+			for (auto& future : readers)
+				future = std::async(std::launch::async, reader);
+
+			// the bucket count grows under the readers, no node is relinked
+			for (int round = 0; round < 3; ++round)
+			{
+				for (size_t i = sizePersist; i < c_size; ++i)
+				{
+					arr[i].v = i;
+					arr[i].valid = true;
+					if (!rSplitTableTryInsert(table, &arr[i].entry, std::hash<size_t>{}(i), equal))
+						throw std::exception("Broken");
+				}
+				Val dup;
+				dup.v = c_size - 1;
+				if (rSplitTableTryInsert(table, &dup.entry, std::hash<size_t>{}(dup.v), equal))
+					throw std::exception("Broken");
+				for (size_t i = sizePersist; i < c_size; ++i)
+				{
+					RSplitNode* pDetached = rSplitTableTryDetachAndSynchronize(
+							table,
+							std::hash<size_t>{}(i),
+							[i](RSplitNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+					if (pDetached != &arr[i].entry)
+						throw std::exception("Broken");
+					arr[i].valid = false;
+				}
+			}
+			finished.store(true, std::memory_order_relaxed);
+			for (auto& future : readers)
+				future.get();
+
+			if (table.core.size.load() != sizePersist || table.core.nrBucketsPowerOf2.load() * 2 < c_size)
+				throw std::exception("Broken");
+			// the single list stays sorted by the split order key
+			RcuSlistHead* p = &table.core.pSegments[0].load()[0].load()->head;
+			for (RcuSlistHead* pNext = p->next.load(); pNext != nullptr; p = pNext, pNext = p->next.load())
+			{
+				size_t soKey = YJ_CONTAINER_OF(p, RSplitNode, head)->soKey;
+				if (soKey >= YJ_CONTAINER_OF(pNext, RSplitNode, head)->soKey)
+					throw std::exception("Broken");
+			}
+		}
+	};
+
+	// One writer inserts and erases the keys inside the blocks of c_blockSize keys, the keys at the
+	// block borders stay. Readers iterate over a block and check that it is sorted and starts and
+	// ends at the borders.
+	struct RSkipListStress
+	{
+		struct Element
+		{
+			uint64_t key;
+			RSkipNode node;
+		};
+		static uint64_t keyOf(const RSkipNode* p)
+		{
+			return YJ_CONTAINER_OF(p, Element, node)->key;
+		}
+		static auto lessThan(uint64_t key)
+		{
+			return [key](const RSkipNode* p) { return keyOf(p) < key; };
+		}
+		static auto equals(uint64_t key)
+		{
+			return [key](const RSkipNode* p) { return keyOf(p) == key; };
+		}
+		static void dispose(RSkipNode* p)
+		{
+			delete YJ_CONTAINER_OF(p, Element, node);
+		}
+
+		static constexpr uint64_t c_blockSize = 100;
+		static constexpr uint64_t c_nrBlocks = 100;
+		RSkipList list;
+		std::atomic<bool> finished = false;
+
+		void insert(uint64_t key)
+		{
+			Element* pElement = new Element{ key, {} };
+			if (!rSkipListTryInsert(
+							list,
+							&pElement->node,
+							[](const RSkipNode* p1, const RSkipNode* p2) { return keyOf(p1) < keyOf(p2); }))
+				throw std::exception("Broken");
+		}
+
+		void reader()
+		{
+			std::mt19937_64 rng(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+			while (!finished.load(std::memory_order_relaxed))
+			{
+				uint64_t low = rng() % c_nrBlocks * c_blockSize;
+				RSkipListReadLockGuard l(list);
+				if (!rSkipListFind(list, lessThan(low), equals(low)))
+					throw std::exception("Broken");
+				uint64_t previous = low;
+				bool reachedHigh = false;
+				size_t nrVisited = rSkipListForEachFrom(
+						list,
+						lessThan(low),
+						[&](RSkipNode* p)
+						{
+							uint64_t key = keyOf(p);
+							if (key == low)
+								return true;
+							if (key <= previous)
+								throw std::exception("Broken");
+							previous = key;
+							reachedHigh = key == low + c_blockSize;
+							return key < low + c_blockSize;
+						});
+				if (nrVisited == 0 || (!reachedHigh && low + c_blockSize < c_nrBlocks * c_blockSize))
+					throw std::exception("Broken");
+			}
+		}
+
+		void run()
+		{
+			rSkipListInit(list);
+			std::vector<uint64_t> keys;
+			for (uint64_t key = 0; key < c_nrBlocks * c_blockSize; ++key)
+				if (key % c_blockSize != 0)
+					keys.push_back(key);
+			std::mt19937_64 rng(7);
+			for (uint64_t iBlock = 0; iBlock < c_nrBlocks; ++iBlock)
+				insert(iBlock * c_blockSize);
+
+			std::vector<std::future<void>> readers;
+			for (int i = 0; i < 2; ++i)
+				readers.push_back(std::async(std::launch::async, [this]() { reader(); }));
+			for (int round = 0; round < 3; ++round)
+			{
+				std::shuffle(keys.begin(), keys.end(), rng);
+				for (uint64_t key : keys)
+					insert(key);
+				if (rSkipListSize(list) != c_nrBlocks * c_blockSize)
+					throw std::exception("Broken");
+				// most blocks by range with one grace period each, every 10th key by key
+				for (uint64_t low = 0; low < c_nrBlocks * c_blockSize; low += c_blockSize)
+				{
+					if (low / c_blockSize % 10 == 1)
+						continue;
+					size_t nrErased = rSkipListEraseRange(
+							list,
+							lessThan(low + 1),
+							[low](const RSkipNode* p) { return keyOf(p) < low + c_blockSize; },
+							dispose);
+					if (nrErased != c_blockSize - 1)
+						throw std::exception("Broken");
+				}
+				for (uint64_t key : keys)
+					if (key / c_blockSize % 10 == 1)
+					{
+						RSkipNode* p = rSkipListTryDetachAndSynchronize(list, lessThan(key), equals(key));
+						if (!p)
+							throw std::exception("Broken");
+						dispose(p);
+					}
+				if (rSkipListSize(list) != c_nrBlocks)
+					throw std::exception("Broken");
+			}
+			finished.store(true, std::memory_order_relaxed);
+			for (auto& reader : readers)
+				reader.get();
+			size_t nrErased = rSkipListEraseRange(
+					list, lessThan(0), [](const RSkipNode*) { return true; }, dispose);
+			if (nrErased != c_nrBlocks || rSkipListFirst(list) != nullptr)
+				throw std::exception("Broken");
+		}
+	};
+
+	struct RFlatTableStress
+	{
+		struct Val
+		{
+			uint64_t v;
+			bool valid = false;
+		};
+		size_t sizeTotal = 8888;
+		size_t sizePersist = 888;
+
+		void run()
+		{
+			RFlatTable fTable;
+			rFlatTableInit(fTable, 16);
+			std::vector<Val> arr = std::vector<Val>{ sizeTotal };
+			for (size_t i = 0; i < sizeTotal; ++i)
+			{
+				arr[i].v = i * 1024;	// strided keys
+				arr[i].valid = true;
+				if (!rFlatTableTryInsert(fTable, arr[i].v, &arr[i]))
+					throw std::exception("Broken");
+				if (rFlatTableTryInsert(fTable, arr[i].v, &arr[i]))
+					throw std::exception("Broken");
+			}
+
+			std::atomic<bool> finished = false;
+			auto f = [&]()
+			{
+				while (!finished.load(std::memory_order_relaxed))
+					for (size_t i = 0; i < sizeTotal; ++i)
+					{
+						RFlatTableReadLockGuard l(fTable);
+						Val* pVal = (Val*)rFlatTableFind(fTable, arr[i].v);
+						if (i < sizePersist && pVal != &arr[i])
+							throw std::exception("Broken");
+						if (pVal && !pVal->valid)
+							throw std::exception("ElementNotValid in reader critical session.");
+					}
+			};
+
+			std::future<void> futures[3];
+			for (auto& future : futures)
+				future = std::async(std::launch::async, f);
+
+			// erase and insert back, the slots are reused or rehashed away
+			for (int j = 0; j < 10; ++j)
+			{
+				for (size_t i = sizePersist; i < sizeTotal; ++i)
+				{
+					void* pDetached = i % 2 == 0
+																? rFlatTableTryDetachAndSynchronize(fTable, arr[i].v)
+																: rFlatTableTryDetachNoSynchronize(fTable, arr[i].v);
+					if (pDetached != &arr[i])
+						throw std::exception("Broken");
+				}
+				rFlatTableSynchronize(fTable);
+				for (size_t i = sizePersist; i < sizeTotal; ++i)
+					arr[i].valid = false;
+				if (fTable.core.size.load() != sizePersist)
+					throw std::exception("Broken");
+
+				for (size_t i = sizePersist; i < sizeTotal; ++i)
+				{
+					arr[i].valid = true;
+					if (!rFlatTableTryInsert(fTable, arr[i].v, &arr[i]))
+						throw std::exception("Broken");
+				}
+			}
+
+			finished.store(true, std::memory_order_relaxed);
+			for (auto& future : futures)
+				future.get();
+
+			for (size_t i = 0; i < sizeTotal; ++i)
+				if (rFlatTableFind(fTable, arr[i].v) != &arr[i])
+					throw std::exception("Broken");
+			if (rFlatTableFind(fTable, 1))
+				throw std::exception("Broken");
+		}
+	};
+	struct RCUTableConcurrentWritersStress
+	{
+		struct Val
+		{
+			size_t v;
+			RNode entry;
+			std::atomic<bool> valid = false;
+		};
+		static constexpr size_t c_nrWriters = 4;
+		static constexpr size_t c_sizePerWriter = 2222;
+		size_t sizePersist = 888;
+
+		static bool equal(RNode* p1, RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Val, entry)->v == YJ_CONTAINER_OF(p2, Val, entry)->v;
+		}
+
+		void run()
+		{
+			RTable rTable;
+			RTableConfig conf{};
+			conf.nrBuckets = 4;
+			conf.nrWriterStripes = 16;
+			rTableInitDetailed(rTable, conf);
+
+			const size_t sizeTotal = c_nrWriters * c_sizePerWriter;
+			std::vector<Val> arr = std::vector<Val>{ sizeTotal };
+			for (size_t i = 0; i < sizePersist; ++i)
+			{
+				arr[i].v = i;
+				arr[i].valid = true;
+				if (!rTableTryInsert(rTable, &arr[i].entry, std::hash<size_t>{}(i), equal))
+					throw std::exception("Broken");
+			}
+
+			std::atomic<bool> finished = false;
+			auto reader = [&]()
+			{
+				while (!finished.load(std::memory_order_relaxed))
+					for (size_t i = 0; i < sizeTotal; ++i)
+					{
+						RTableReadLockGuard l(rTable);
+						RNode* pFound = rTableFind(
+								rTable,
+								std::hash<size_t>{}(i),
+								[&](RNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+						if (i < sizePersist && !pFound)
+							throw std::exception("Broken");
+						if (pFound && !YJ_CONTAINER_OF(pFound, Val, entry)->valid)
+							throw std::exception("ElementNotValid in reader critical session.");
+					}
+			};
+
+			// every writer owns an interleaved part of the keys, and grows and shrinks the table
+			// concurrently with the others
+			auto writer = [&](size_t iWriter)
+			{
+				for (int round = 0; round < 3; ++round)
+				{
+					for (size_t i = iWriter; i < sizeTotal; i += c_nrWriters)
+					{
+						if (i < sizePersist)
+							continue;
+						arr[i].v = i;
+						arr[i].valid = true;
+						if (!rTableConcurrentTryInsert(
+										rTable, &arr[i].entry, std::hash<size_t>{}(i), equal))
+							throw std::exception("Broken");
+					}
+					for (size_t i = iWriter; i < sizeTotal; i += c_nrWriters)
+					{
+						if (i < sizePersist)
+							continue;
+						RNode* pDetached = rTableConcurrentTryDetachAndSynchronize(
+								rTable,
+								std::hash<size_t>{}(i),
+								[i](RNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+						if (pDetached != &arr[i].entry)
+							throw std::exception("Broken");
+						arr[i].valid = false;
+					}
+				}
+			};
+
+			std::future<void> readers[2];
+			for (auto& future : readers)
+				future = std::async(std::launch::async, reader);
+			std::future<void> writers[c_nrWriters];
+			for (size_t iWriter = 0; iWriter < c_nrWriters; ++iWriter)
+				writers[iWriter] = std::async(std::launch::async, writer, iWriter);
+			for (auto& future : writers)
+				future.get();
+			finished.store(true, std::memory_order_relaxed);
+			for (auto& future : readers)
+				future.get();
+
+			if (rTable.core.size.load() != sizePersist)
+				throw std::exception("Broken");
+		}
+	};
+	struct RShardedTableStress
+	{
+		struct Val
+		{
+			size_t v;
+			RNode entry;
+			std::atomic<bool> valid = false;
+		};
+		static constexpr size_t c_nrWriters = 4;
+		static constexpr size_t c_sizePerWriter = 2222;
+		size_t sizePersist = 888;
+
+		// the shard is selected by the high bits, spread the integer keys over them
+		static size_t hashOf(size_t v)
+		{
+			return v * 0x9E3779B97F4A7C15ull;
+		}
+
+		static bool equal(RNode* p1, RNode* p2)
+		{
+			return YJ_CONTAINER_OF(p1, Val, entry)->v == YJ_CONTAINER_OF(p2, Val, entry)->v;
+		}
+
+		void run()
+		{
+			RShardedTable table;
+			RShardedTableConfig conf{};
+			conf.nrShardBits = 3;
+			conf.nrBucketsPerShard = 4;
+			rShardedTableInitDetailed(table, conf);
+
+			const size_t sizeTotal = c_nrWriters * c_sizePerWriter;
+			std::vector<Val> arr = std::vector<Val>{ sizeTotal };
+			for (size_t i = 0; i < sizePersist; ++i)
+			{
+				arr[i].v = i;
+				arr[i].valid = true;
+				if (!rShardedTableTryInsert(table, &arr[i].entry, hashOf(i), equal))
+					throw std::exception("Broken");
+			}
+
+			std::atomic<bool> finished = false;
+			auto reader = [&]()
+			{
+				while (!finished.load(std::memory_order_relaxed))
+					for (size_t i = 0; i < sizeTotal; ++i)
+					{
+						RShardedTableReadLockGuard l(table);
+						RNode* pFound = rShardedTableFind(
+								table,
+								hashOf(i),
+								[&](RNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+						if (i < sizePersist && !pFound)
+							throw std::exception("Broken");
+						if (pFound && !YJ_CONTAINER_OF(pFound, Val, entry)->valid)
+							throw std::exception("ElementNotValid in reader critical session.");
+					}
+			};
+
+			auto writer = [&](size_t iWriter)
+			{
+				for (int round = 0; round < 3; ++round)
+				{
+					for (size_t i = iWriter; i < sizeTotal; i += c_nrWriters)
+					{
+						if (i < sizePersist)
+							continue;
+						arr[i].v = i;
+						arr[i].valid = true;
+						if (!rShardedTableTryInsert(table, &arr[i].entry, hashOf(i), equal))
+							throw std::exception("Broken");
+					}
+					for (size_t i = iWriter; i < sizeTotal; i += c_nrWriters)
+					{
+						if (i < sizePersist)
+							continue;
+						RNode* pDetached = rShardedTableTryDetachAndSynchronize(
+								table,
+								hashOf(i),
+								[i](RNode* p) { return YJ_CONTAINER_OF(p, Val, entry)->v == i; });
+						if (pDetached != &arr[i].entry)
+							throw std::exception("Broken");
+						arr[i].valid = false;
+					}
+				}
+			};
+
+			// shard local maintenance running next to the writers
+			auto maintainer = [&]()
+			{
+				for (size_t iShard = 0; iShard < rShardedTableNrShards(table); ++iShard)
+				{
+					rShardedTableExpandShard2x(table, iShard);
+					rShardedTableShrinkShard2x(table, iShard);
+				}
+			};
+
+			std::future<void> readers[2];
+			for (auto& future : readers)
+				future = std::async(std::launch::async, reader);
+			std::future<void> writers[c_nrWriters];
+			for (size_t iWriter = 0; iWriter < c_nrWriters; ++iWriter)
+				writers[iWriter] = std::async(std::launch::async, writer, iWriter);
+			std::future<void> maintenance = std::async(std::launch::async, maintainer);
+			for (auto& future : writers)
+				future.get();
+			maintenance.get();
+			finished.store(true, std::memory_order_relaxed);
+			for (auto& future : readers)
+				future.get();
+
+			if (rShardedTableSize(table) != sizePersist)
+				throw std::exception("Broken");
+		}
+	};
+}	 // namespace
+
+void rTableTests()
+{
+	RcuDlistTest dlistTest;
+	dlistTest.run();
+
+	RCUTableManualStressExpandShrink testManualShrinkExpand;
+	testManualShrinkExpand.run();
+
+	RCUTableTestSingleThreadTest();
+
+	RCUTableFindBatchTest();
+
+	RCUTableMappedBucketsTest();
+
+	RCUTableForEachTest();
+
+	RCUTableScanTest();
+
+	RCUTableSnapshotTest();
+	RCUTableBulkInsertTest();
+	RCUTableEraseManyTest();
+	RCUTableReplaceTest();
+	RCUTableFindOrInsertTest();
+	RCUTableMultiMapTest();
+	RCUTableHashersTest();
+	RCUTableStatsTest();
+	RCUTableBloomTest();
+	RCUTableHandleTest();
+	RCUTableHotCacheTest();
+
+	RHashMapTest();
+	RCacheTest();
+	RCompactTableTest();
+	RTableCombinerTest();
+
+	RNodePoolStress nodePoolStress;
+	nodePoolStress.run();
+
+	RFlatTableStress flatTableStress;
+	flatTableStress.run();
+
+	RCUTableConcurrentWritersStress concurrentWritersStress;
+	concurrentWritersStress.run();
+
+	RShardedTableStress shardedTableStress;
+	shardedTableStress.run();
+
+	RSplitTableStress splitTableStress;
+	splitTableStress.run();
+
+	RSkipListStress skipListStress;
+	skipListStress.run();
 
 	PerfComparisonWithStdUnorderedSet comp;
 	comp.run();